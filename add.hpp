@@ -0,0 +1,8 @@
+#pragma once
+
+// Playing with templates
+
+template<typename T>
+T add(T a, T b) {
+    return a + b;
+}
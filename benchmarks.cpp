@@ -0,0 +1,419 @@
+#include "catch.hpp"
+
+#include "add.hpp"
+#include "factorial.hpp"
+#include "point.hpp"
+#include "fakeit.hpp"
+#include "catch-extensions/parallel-generate.hpp"
+#include "catch-extensions/range-assertions.hpp"
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Benchmarks live in their own executable (cpp_playground_bench) so that
+// CATCH_CONFIG_ENABLE_BENCHMARKING doesn't leak into the regular test build.
+//
+// Each kernel is benchmarked for a range of input sizes. The default run covers 10 to 10^5,
+// the hidden "[large]" test case covers 10^6 and 10^7 (try it with --benchmark-samples 10).
+
+// What benchmarkMockedCalls mocks. Not in the anonymous namespace: GCC would see that nothing
+// implements it there, and take calls to it for unreachable.
+struct Collaborator {
+    virtual int next(int) = 0;
+
+    virtual int previous(int) = 0;
+};
+
+namespace {
+    std::string sized(const std::string &name, std::size_t n) {
+        return name + " (n = " + std::to_string(n) + ")";
+    }
+
+    std::vector<int> iota(std::size_t n) {
+        std::vector<int> vec(n);
+        std::iota(vec.begin(), vec.end(), 1);
+        return vec;
+    }
+
+    std::vector<int> shuffled(std::size_t n) {
+        auto vec = iota(n);
+        std::shuffle(vec.begin(), vec.end(), std::mt19937{42});
+        return vec;
+    }
+
+    std::vector<std::string> words(std::size_t n) {
+        const std::vector<std::string> sentence{"Programming", "in", "a", "functional", "style."};
+        std::vector<std::string> str;
+        str.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            str.push_back(sentence[i % sentence.size()]);
+        }
+        return str;
+    }
+
+    std::vector<std::pair<int, int>> pairs(std::size_t n) {
+        std::mt19937 rng{42};
+        std::uniform_int_distribution<int> dist;
+        std::vector<std::pair<int, int>> tester(n);
+        for (auto &p : tester) {
+            p = std::make_pair(dist(rng), dist(rng));
+        }
+        return tester;
+    }
+
+    // Same as Foo/compareFunction in cpp-in-y-minutes.cpp
+    struct Foo {
+        int j;
+
+        Foo(int a) : j(a) {}
+    };
+
+    struct compareFunction {
+        bool operator()(const Foo &a, const Foo &b) const {
+            return a.j < b.j;
+        }
+    };
+
+    void benchmarkFactorial(std::size_t n) {
+        // Factorial overflows an unsigned int past 12, so cycle through 0..12
+        BENCHMARK(sized("Factorial", n)) {
+            unsigned int sum = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                sum += Factorial(i % 13);
+            }
+            return sum;
+        };
+    }
+
+    void benchmarkAdd(std::size_t n) {
+        // Small enough that adding up 10^7 of them doesn't overflow an int
+        auto ints = iota(n);
+        for (auto &i : ints) {
+            i %= 100;
+        }
+        std::vector<double> doubles(ints.begin(), ints.end());
+
+        BENCHMARK(sized("add<int>", n)) {
+            int sum = 0;
+            for (auto i : ints) {
+                sum = add(sum, i);
+            }
+            return sum;
+        };
+
+        BENCHMARK(sized("add<double>", n)) {
+            double sum = 0;
+            for (auto d : doubles) {
+                sum = add(sum, d);
+            }
+            return sum;
+        };
+    }
+
+    void benchmarkPoint(std::size_t n) {
+        std::vector<Point> points;
+        points.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            points.emplace_back(i, n - i);
+        }
+
+        BENCHMARK(sized("Point::operator+", n)) {
+            Point result(0, 0);
+            for (auto &p : points) {
+                result = result + p;
+            }
+            return result;
+        };
+
+        BENCHMARK(sized("Point::operator+=", n)) {
+            Point result(0, 0);
+            for (auto &p : points) {
+                result += p;
+            }
+            return result;
+        };
+    }
+
+    // The pipelines from the "Map", "Filter" and "Reduce" tests
+    void benchmarkMapFilterReduce(std::size_t n) {
+        auto vec = iota(n);
+        // Small enough to square as ints
+        auto roots = vec;
+        for (auto &i : roots) {
+            i %= 46341;
+        }
+
+        BENCHMARK_ADVANCED(sized("Map", n))(Catch::Benchmark::Chronometer meter) {
+            std::vector<std::vector<int>> inputs(meter.runs(), roots);
+            meter.measure([&inputs](int run) {
+                auto &v = inputs[run];
+                std::transform(v.begin(), v.end(), v.begin(), [](int i) { return i * i; });
+                return v.back();
+            });
+        };
+
+        BENCHMARK(sized("Filter", n)) {
+            std::vector<int> evens;
+            std::copy_if(vec.begin(), vec.end(), std::back_inserter(evens), [](int i) { return i % 2 == 0; });
+            return evens;
+        };
+
+        BENCHMARK(sized("Reduce (sum)", n)) {
+            return std::accumulate(vec.begin(), vec.end(), 0LL, [](long long a, int b) { return a + b; });
+        };
+
+        BENCHMARK(sized("Reduce (product)", n)) {
+            // Unsigned, so that it wraps around rather than overflows
+            return std::accumulate(vec.begin(), vec.end(), 1u, [](unsigned a, int b) { return a * static_cast<unsigned>(b); });
+        };
+
+        // Taking the accumulator by value copies an ever growing string on every step,
+        // so this one is quadratic and would take minutes past 10^4
+        if (n <= 10000) {
+            auto str = words(n);
+            BENCHMARK(sized("Reduce (strings)", n)) {
+                return std::accumulate(str.begin(), str.end(), std::string(""),
+                                       [](std::string a, std::string b) { return a + ":" + b; });
+            };
+        }
+    }
+
+    // The containers from the "Sets", "Maps" and "Custom Comparator" tests
+    void benchmarkContainers(std::size_t n) {
+        auto keys = shuffled(n);
+
+        BENCHMARK(sized("std::set insert", n)) {
+            std::set<int> ST;
+            for (auto k : keys) {
+                ST.insert(k);
+            }
+            return ST.size();
+        };
+
+        std::set<int> ST(keys.begin(), keys.end());
+        BENCHMARK(sized("std::set find", n)) {
+            std::size_t found = 0;
+            for (auto k : keys) {
+                found += ST.find(k) != ST.end();
+            }
+            return found;
+        };
+
+        BENCHMARK(sized("std::map insert", n)) {
+            std::map<int, int> mymap;
+            for (auto k : keys) {
+                mymap.insert(std::pair<int, int>(k, k));
+            }
+            return mymap.size();
+        };
+
+        std::map<int, int> mymap;
+        for (auto k : keys) {
+            mymap[k] = k;
+        }
+        BENCHMARK(sized("std::map find", n)) {
+            long sum = 0;
+            for (auto k : keys) {
+                sum += mymap.find(k)->second;
+            }
+            return sum;
+        };
+
+        BENCHMARK(sized("std::map with custom comparator", n)) {
+            std::map<Foo, int, compareFunction> fooMap;
+            for (auto k : keys) {
+                fooMap[Foo(k)] = k;
+            }
+            return fooMap.find(Foo(keys.front()))->second;
+        };
+    }
+
+    // The sort from the "Lambda Expressions" test
+    void benchmarkSortPairs(std::size_t n) {
+        auto tester = pairs(n);
+
+        BENCHMARK_ADVANCED(sized("sort pairs by second", n))(Catch::Benchmark::Chronometer meter) {
+            std::vector<std::vector<std::pair<int, int>>> inputs(meter.runs(), tester);
+            meter.measure([&inputs](int run) {
+                auto &v = inputs[run];
+                std::sort(v.begin(), v.end(), [](const std::pair<int, int> &lhs, const std::pair<int, int> &rhs) {
+                    return lhs.second < rhs.second;
+                });
+                return v.front();
+            });
+        };
+    }
+
+    // What the tests pay per assertion: a passing REQUIRE only bumps a counter, unless it's
+    // reported (-s, or a reporter that wants every assertion, like xml and junit)
+    void benchmarkAssertions(std::size_t n) {
+        auto vec = iota(n);
+
+        BENCHMARK(sized("passing REQUIRE", n)) {
+            for (std::size_t i = 0; i < n; ++i) {
+                REQUIRE(vec[i] == static_cast<int>(i + 1));
+            }
+        };
+
+        // The same check as one assertion
+        BENCHMARK(sized("REQUIRE_ALL_OF", n)) {
+            REQUIRE_ALL_OF(vec, [](int i) { return i > 0; });
+        };
+
+        // The same REQUIREs, run for every value of a generator on a thread pool
+        BENCHMARK(sized("GENERATE_PARALLEL REQUIRE", n)) {
+            GENERATE_PARALLEL(range<std::size_t>(0, n), [&](std::size_t i) {
+                REQUIRE(vec[i] == static_cast<int>(i + 1));
+            });
+        };
+    }
+
+    // Picking the test cases for a filter like "[tag]" or "Name*", by matching it against every
+    // test case, and through the registry's name and tag index
+    void benchmarkFiltering(std::size_t n) {
+        std::vector<Catch::TestCase> testCases;
+        testCases.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            auto name = "Test case " + std::to_string(i);
+            auto tags = "[tag" + std::to_string(i % 100) + "]";
+            testCases.push_back(Catch::makeTestCase(nullptr, "", Catch::NameAndTags(name.c_str(), tags.c_str()),
+                                                    CATCH_INTERNAL_LINEINFO));
+        }
+        Catch::TestCaseIndex index(testCases);
+
+        for (auto filter : {"[tag7]", "Test case 42*"}) {
+            auto spec = Catch::TestSpecParser(Catch::ITagAliasRegistry::get()).parse(filter).testSpec();
+
+            BENCHMARK(sized(std::string("scan ") + filter, n)) {
+                std::size_t matches = 0;
+                for (auto &testCase : testCases) {
+                    matches += spec.matches(testCase);
+                }
+                return matches;
+            };
+
+            BENCHMARK(sized(std::string("index ") + filter, n)) {
+                auto positions = filter[0] == '[' ? index.withTag("tag7") : index.withNamePrefix("test case 42");
+                std::size_t matches = 0;
+                for (auto position : positions) {
+                    matches += spec.matches(testCases[position]);
+                }
+                return matches;
+            };
+        }
+
+        BENCHMARK(sized("build index", n)) {
+            return Catch::TestCaseIndex(testCases);
+        };
+    }
+
+    // Calling a stubbed method of a mock, which records every invocation, until the history's cleared,
+    // and verifying a history of n invocations of two methods
+    void benchmarkMockedCalls(std::size_t n) {
+        fakeit::Mock<Collaborator> mock;
+        fakeit::When(Method(mock, next)).AlwaysReturn(1);
+        fakeit::When(Method(mock, previous)).AlwaysReturn(-1);
+        Collaborator &collaborator = mock.get();
+
+        BENCHMARK(sized("mocked calls", n)) {
+            int sum = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                sum += collaborator.next(static_cast<int>(i));
+            }
+            mock.ClearInvocationHistory();
+            return sum;
+        };
+
+        // Which of 100 stubs, each for one argument, a call matches
+        fakeit::Mock<Collaborator> exact;
+        for (int k = 0; k < 100; ++k) {
+            fakeit::When(Method(exact, next).Using(k)).AlwaysReturn(k);
+        }
+        Collaborator &exactCollaborator = exact.get();
+
+        BENCHMARK(sized("mocked calls, 100 exact stubs", n)) {
+            int sum = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                sum += exactCollaborator.next(static_cast<int>(i % 100));
+            }
+            exact.ClearInvocationHistory();
+            return sum;
+        };
+
+        for (std::size_t i = 0; i < n / 2; ++i) {
+            collaborator.next(static_cast<int>(i));
+            collaborator.previous(static_cast<int>(i));
+        }
+
+        BENCHMARK(sized("Verify", n)) {
+            fakeit::Verify(Method(mock, next) + Method(mock, previous)).Exactly(n / 2);
+        };
+
+        // A pattern 102 invocations long, whose first 100 match from every other invocation on
+        BENCHMARK(sized("Verify a near miss", n)) {
+            fakeit::Verify((Method(mock, next) + Method(mock, previous)) * 50 + Method(mock, next) * 2).Never();
+        };
+
+        BENCHMARK(sized("VerifyNoOtherInvocations", n)) {
+            fakeit::VerifyNoOtherInvocations(mock);
+        };
+    }
+
+    void benchmarkEverything(std::size_t n) {
+        benchmarkFactorial(n);
+        benchmarkAdd(n);
+        benchmarkPoint(n);
+        benchmarkMapFilterReduce(n);
+        benchmarkContainers(n);
+        benchmarkSortPairs(n);
+        benchmarkAssertions(n);
+        benchmarkFiltering(n);
+        benchmarkMockedCalls(n);
+    }
+}
+
+TEST_CASE("Factorial benchmark", "[benchmark][factorial]") {
+    benchmarkFactorial(GENERATE(10, 1000, 100000));
+}
+
+TEST_CASE("Generic add benchmark", "[benchmark][add]") {
+    benchmarkAdd(GENERATE(10, 1000, 100000));
+}
+
+TEST_CASE("Point benchmark", "[benchmark][point]") {
+    benchmarkPoint(GENERATE(10, 1000, 100000));
+}
+
+TEST_CASE("Map, Filter, Reduce benchmark", "[benchmark][hof]") {
+    benchmarkMapFilterReduce(GENERATE(10, 1000, 100000));
+}
+
+TEST_CASE("Containers benchmark", "[benchmark][containers]") {
+    benchmarkContainers(GENERATE(10, 1000, 100000));
+}
+
+TEST_CASE("Lambda sort benchmark", "[benchmark][sort]") {
+    benchmarkSortPairs(GENERATE(10, 1000, 100000));
+}
+
+TEST_CASE("Assertions benchmark", "[benchmark][assertions]") {
+    benchmarkAssertions(GENERATE(10, 1000, 100000));
+}
+
+TEST_CASE("Test filtering benchmark", "[benchmark][filtering]") {
+    benchmarkFiltering(GENERATE(10, 1000, 100000));
+}
+
+TEST_CASE("Mocked calls benchmark", "[benchmark][mock]") {
+    benchmarkMockedCalls(GENERATE(10, 1000, 100000));
+}
+
+TEST_CASE("Large inputs benchmark", "[.][benchmark][large]") {
+    benchmarkEverything(GENERATE(1000000, 10000000));
+}
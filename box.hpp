@@ -0,0 +1,13 @@
+#pragma once
+
+template<class T>
+class Box {
+public:
+    // In this class, T can be used as any other type.
+    T insert(const T t);
+};
+
+template<class T>
+T Box<T>::insert(const T t) {
+    return t;
+}
@@ -0,0 +1,210 @@
+// The allocation counter behind allocations.hpp, and the listener that reports what every test case
+// and section allocated when the tests are run with --allocations.
+//
+// With glibc it replaces malloc and friends, so the allocations of C code count too; elsewhere it
+// replaces the (unaligned) operator new/delete.
+
+#define CATCH_CONFIG_EXTERNAL_INTERFACES
+
+#include "catch.hpp"
+
+#include "allocations.hpp"
+#include "options.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace {
+    // Zero-initialized, so using it from inside malloc never needs a constructor to run (or malloc)
+    thread_local extensions::detail::AllocationCounters counters;
+
+    void allocated(std::size_t requested, std::size_t size) {
+        ++counters.count;
+        counters.bytes += requested;
+        counters.liveBytes += size;
+        if (counters.liveBytes > counters.peakLiveBytes) {
+            counters.peakLiveBytes = counters.liveBytes;
+        }
+    }
+
+    void freed(std::size_t size) {
+        // Memory allocated on another thread is freed here, so don't go below zero
+        counters.liveBytes -= size < counters.liveBytes ? size : counters.liveBytes;
+    }
+}
+
+namespace extensions {
+    namespace detail {
+        AllocationCounters &allocationCounters() {
+            return counters;
+        }
+    }
+}
+
+#if defined(__GLIBC__)
+
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t count, std::size_t size);
+void *__libc_realloc(void *ptr, std::size_t size);
+void *__libc_memalign(std::size_t alignment, std::size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(std::size_t size) {
+    void *ptr = __libc_malloc(size);
+    if (ptr) {
+        allocated(size, malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void *calloc(std::size_t count, std::size_t size) {
+    void *ptr = __libc_calloc(count, size);
+    if (ptr) {
+        allocated(count * size, malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void *realloc(void *ptr, std::size_t size) {
+    std::size_t before = ptr ? malloc_usable_size(ptr) : 0;
+    void *result = __libc_realloc(ptr, size);
+    if (result || size == 0) {
+        freed(before);
+    }
+    if (result) {
+        allocated(size, malloc_usable_size(result));
+    }
+    return result;
+}
+
+void *memalign(std::size_t alignment, std::size_t size) {
+    void *ptr = __libc_memalign(alignment, size);
+    if (ptr) {
+        allocated(size, malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void *aligned_alloc(std::size_t alignment, std::size_t size) {
+    return memalign(alignment, size);
+}
+
+int posix_memalign(void **result, std::size_t alignment, std::size_t size) {
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void *ptr = memalign(alignment, size);
+    if (!ptr) {
+        return ENOMEM;
+    }
+    *result = ptr;
+    return 0;
+}
+
+void free(void *ptr) {
+    if (ptr) {
+        freed(malloc_usable_size(ptr));
+    }
+    __libc_free(ptr);
+}
+}
+
+#else
+
+namespace {
+    // Big enough to keep the alignment malloc guarantees
+    constexpr std::size_t header = alignof(std::max_align_t);
+
+    void *countedNew(std::size_t size) {
+        auto block = static_cast<char *>(std::malloc(size + header));
+        if (!block) {
+            return nullptr;
+        }
+        *reinterpret_cast<std::size_t *>(block) = size;
+        allocated(size, size);
+        return block + header;
+    }
+
+    void countedDelete(void *ptr) {
+        if (ptr) {
+            auto block = static_cast<char *>(ptr) - header;
+            freed(*reinterpret_cast<std::size_t *>(block));
+            std::free(block);
+        }
+    }
+}
+
+void *operator new(std::size_t size) {
+    if (void *ptr = countedNew(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, std::nothrow_t const &) noexcept {
+    return countedNew(size);
+}
+
+void *operator new[](std::size_t size, std::nothrow_t const &) noexcept {
+    return countedNew(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    countedDelete(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    countedDelete(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    countedDelete(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    countedDelete(ptr);
+}
+
+#endif
+
+namespace {
+    // Reports each section's (and test case's) allocations as it ends, the way --durations reports
+    // their durations. This includes what Catch itself allocates while running them.
+    struct AllocationListener : Catch::TestEventListenerBase {
+        using TestEventListenerBase::TestEventListenerBase;
+
+        void sectionStarting(Catch::SectionInfo const &sectionInfo) override {
+            TestEventListenerBase::sectionStarting(sectionInfo);
+            if (extensions::options().allocations) {
+                scopes.emplace_back();
+            }
+        }
+
+        void sectionEnded(Catch::SectionStats const &sectionStats) override {
+            if (extensions::options().allocations && !scopes.empty()) {
+                auto allocations = scopes.back().end();
+                scopes.pop_back();
+                Catch::cout() << allocations.count << " allocations, " << allocations.bytes << " bytes, peak "
+                              << allocations.peakBytes << " bytes: " << sectionStats.sectionInfo.name << std::endl;
+            }
+            TestEventListenerBase::sectionEnded(sectionStats);
+        }
+
+    private:
+        std::vector<extensions::detail::AllocationScope> scopes;
+    };
+}
+
+CATCH_REGISTER_LISTENER(AllocationListener)
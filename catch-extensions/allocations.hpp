@@ -0,0 +1,74 @@
+#pragma once
+
+// Counts the heap allocations made on the current thread. Needs catch-extensions/allocations.cpp
+// linked in (the allocation_counter library), which replaces malloc/free (or, without glibc,
+// operator new/delete) with versions that keep count.
+//
+//   REQUIRE_ALLOCATIONS(== 0, p += q);
+//
+// fails, showing the count, if `p += q` allocates. With --allocations every test case and
+// section also reports how much it allocated, like --durations reports how long it took.
+
+#include <cstddef>
+
+namespace extensions {
+
+    struct Allocations {
+        std::size_t count = 0;
+        std::size_t bytes = 0;
+        // The most bytes that were allocated at once, on top of what already was (as malloc rounds them up)
+        std::size_t peakBytes = 0;
+    };
+
+    namespace detail {
+        struct AllocationCounters {
+            std::size_t count;
+            std::size_t bytes;
+            std::size_t liveBytes;
+            std::size_t peakLiveBytes;
+        };
+
+        // This thread's
+        AllocationCounters &allocationCounters();
+
+        class AllocationScope {
+        public:
+            AllocationScope() : before(allocationCounters()) {
+                allocationCounters().peakLiveBytes = before.liveBytes;
+            }
+
+            Allocations end() const {
+                auto &counters = allocationCounters();
+                Allocations allocations;
+                allocations.count = counters.count - before.count;
+                allocations.bytes = counters.bytes - before.bytes;
+                allocations.peakBytes = counters.peakLiveBytes - before.liveBytes;
+                if (before.peakLiveBytes > counters.peakLiveBytes) {
+                    counters.peakLiveBytes = before.peakLiveBytes;
+                }
+                return allocations;
+            }
+
+        private:
+            AllocationCounters before;
+        };
+    }
+
+    // The allocations f makes on this thread
+    template<typename F>
+    Allocations countAllocations(F &&f) {
+        detail::AllocationScope scope;
+        f();
+        return scope.end();
+    }
+}
+
+#define INTERNAL_CHECK_ALLOCATIONS(macro, comparison, ...) \
+    do { \
+        auto allocations = ::extensions::countAllocations([&] { __VA_ARGS__; }).count; \
+        INFO("allocations made by: " #__VA_ARGS__); \
+        macro(allocations comparison); \
+    } while (false)
+
+#define REQUIRE_ALLOCATIONS(comparison, ...) INTERNAL_CHECK_ALLOCATIONS(REQUIRE, comparison, __VA_ARGS__)
+#define CHECK_ALLOCATIONS(comparison, ...) INTERNAL_CHECK_ALLOCATIONS(CHECK, comparison, __VA_ARGS__)
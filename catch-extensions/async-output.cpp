@@ -0,0 +1,289 @@
+// The ring buffer behind async-output.hpp. There's a single writer (the test thread) and a single
+// reader (the background thread), so it only takes two atomic counters: the bytes written into it
+// and the bytes written out of it. The background thread only ever sleeps for a few milliseconds,
+// and is only woken up early once there's a batch's worth of output, or for flush().
+//
+// Should the tests crash, whatever Catch reports about it is still written out: its signal handler
+// passes the signal on to the one here, which waits for the background thread to empty the ring, and
+// writes what's still in std::cout's buffer out itself, before the process dies.
+
+#include "async-output.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <ctime>
+#include <pthread.h>
+#include <unistd.h>
+#define ASYNC_OUTPUT_SIGNALS
+#endif
+
+namespace {
+    constexpr std::size_t batchSize = 64 * 1024;
+    constexpr auto maxDelay = std::chrono::milliseconds(10);
+}
+
+namespace extensions {
+
+    struct AsyncOutput::State : std::streambuf {
+        std::vector<char> ring;
+        std::atomic<std::size_t> written{0};
+        std::atomic<std::size_t> writtenOut{0};
+        // How much was written when the background thread was last woken up
+        std::size_t woken = 0;
+
+        std::mutex mutex;
+        std::condition_variable wakeUp;
+        std::atomic<bool> sleeping{false};
+        std::atomic<bool> stopping{false};
+        std::thread thread;
+
+        // std::cout's own, for afterwards
+        std::streambuf *coutBuffer = nullptr;
+        // The real stdout, which the background thread writes everything out to
+        std::FILE *out = nullptr;
+#if defined(ASYNC_OUTPUT_SIGNALS)
+        int outFd = -1;
+#endif
+#if defined(__GLIBC__)
+        std::FILE *cookie = nullptr;
+#endif
+        // What's been written to std::cout but not into the ring yet
+        char pending[8 * 1024];
+        // While sync() is moving pending into the ring, for drainForSignal()
+        volatile std::sig_atomic_t syncing = 0;
+
+        explicit State(std::size_t capacity) : ring(capacity) {
+            setp(pending, pending + sizeof(pending));
+        }
+
+        // Called on the test thread
+
+        void push(const char *data, std::size_t size) {
+            auto head = written.load(std::memory_order_relaxed);
+            while (size > 0) {
+                auto space = ring.size() - (head - writtenOut.load(std::memory_order_acquire));
+                if (space == 0) {
+                    wake();
+                    std::this_thread::yield();
+                    continue;
+                }
+                auto offset = head % ring.size();
+                auto chunk = std::min({size, space, ring.size() - offset});
+                std::memcpy(ring.data() + offset, data, chunk);
+                head += chunk;
+                data += chunk;
+                size -= chunk;
+                written.store(head, std::memory_order_release);
+            }
+            if (head - woken >= batchSize) {
+                wake();
+            }
+        }
+
+        void wake() {
+            woken = written.load(std::memory_order_relaxed);
+            if (sleeping.load()) {
+                std::lock_guard<std::mutex> lock(mutex);
+                wakeUp.notify_one();
+            }
+        }
+
+        void drain() {
+            sync();
+            wake();
+            while (writtenOut.load(std::memory_order_acquire) != written.load(std::memory_order_relaxed)) {
+                std::this_thread::yield();
+            }
+        }
+
+#if defined(ASYNC_OUTPUT_SIGNALS)
+        // drain() for a signal handler, which can have interrupted the test thread anywhere, push()
+        // and wake() included: so it takes no lock and leaves the ring and the streambuf as they are.
+        // The background thread, which has the signals blocked, looks at the ring every maxDelay
+        // anyway; this gives it a second to catch up, then writes std::cout's pending output itself.
+        void drainForSignal() {
+            auto head = written.load(std::memory_order_acquire);
+            timespec poll{0, 1000 * 1000};
+            for (int polls = 0; polls < 1000 && writtenOut.load(std::memory_order_acquire) != head; ++polls) {
+                nanosleep(&poll, nullptr);
+            }
+            // If sync() was interrupted, some of it may be in the ring already: better lost than written twice
+            auto size = syncing ? 0 : static_cast<std::size_t>(pptr() - pbase());
+            for (const char *data = pbase(); size > 0;) {
+                auto done = write(outFd, data, size);
+                if (done <= 0) {
+                    break;
+                }
+                data += done;
+                size -= static_cast<std::size_t>(done);
+            }
+        }
+#endif
+
+        int sync() override {
+            syncing = 1;
+            push(pbase(), static_cast<std::size_t>(pptr() - pbase()));
+            setp(pending, pending + sizeof(pending));
+            syncing = 0;
+            return 0;
+        }
+
+        int_type overflow(int_type c) override {
+            sync();
+            if (!traits_type::eq_int_type(c, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(c);
+                pbump(1);
+            }
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(const char *data, std::streamsize size) override {
+            if (size > epptr() - pptr()) {
+                sync();
+                push(data, static_cast<std::size_t>(size));
+            } else {
+                std::memcpy(pptr(), data, static_cast<std::size_t>(size));
+                pbump(static_cast<int>(size));
+            }
+            return size;
+        }
+
+        // The background thread
+
+        void writeOut() {
+            auto tail = writtenOut.load(std::memory_order_relaxed);
+            for (;;) {
+                auto head = written.load(std::memory_order_acquire);
+                if (head == tail) {
+                    if (stopping.load() && written.load() == tail) {
+                        return;
+                    }
+                    std::unique_lock<std::mutex> lock(mutex);
+                    sleeping.store(true);
+                    wakeUp.wait_for(lock, maxDelay, [&] {
+                        return written.load() - tail >= batchSize || stopping.load();
+                    });
+                    sleeping.store(false);
+                    continue;
+                }
+                while (tail != head) {
+                    auto offset = tail % ring.size();
+                    auto chunk = std::min(head - tail, ring.size() - offset);
+                    std::fwrite(ring.data() + offset, 1, chunk, out);
+                    tail += chunk;
+                }
+                std::fflush(out);
+                writtenOut.store(tail, std::memory_order_release);
+            }
+        }
+    };
+}
+
+namespace {
+    extensions::AsyncOutput::State *active = nullptr;
+
+#if defined(__GLIBC__)
+    // printf and co., once stdout is this (unbuffered) cookie file: into the ring after std::cout's pending output
+    ssize_t writeCookie(void *cookie, const char *data, std::size_t size) {
+        auto state = static_cast<extensions::AsyncOutput::State *>(cookie);
+        state->sync();
+        state->push(data, size);
+        return static_cast<ssize_t>(size);
+    }
+#endif
+
+#if defined(ASYNC_OUTPUT_SIGNALS)
+    const int signals[] = {SIGINT, SIGILL, SIGFPE, SIGSEGV, SIGTERM, SIGABRT};
+    struct sigaction previousActions[sizeof(signals) / sizeof(signals[0])];
+
+    void handleSignal(int sig) {
+        if (active) {
+            active->drainForSignal();
+        }
+        for (std::size_t i = 0; i < sizeof(signals) / sizeof(signals[0]); ++i) {
+            if (signals[i] == sig) {
+                sigaction(sig, &previousActions[i], nullptr);
+            }
+        }
+        raise(sig);
+    }
+#endif
+}
+
+namespace extensions {
+
+    AsyncOutput::AsyncOutput(std::size_t capacity) : state(new State(capacity)) {
+        std::fflush(stdout);
+        state->out = stdout;
+        state->coutBuffer = std::cout.rdbuf(state.get());
+#if defined(ASYNC_OUTPUT_SIGNALS)
+        state->outFd = fileno(stdout);
+        // So that handleSignal runs on the test thread, never on the background one it waits on
+        sigset_t blocked, previousMask;
+        sigemptyset(&blocked);
+        for (auto sig : signals) {
+            sigaddset(&blocked, sig);
+        }
+        pthread_sigmask(SIG_BLOCK, &blocked, &previousMask);
+        state->thread = std::thread([this] { state->writeOut(); });
+        pthread_sigmask(SIG_SETMASK, &previousMask, nullptr);
+#else
+        state->thread = std::thread([this] { state->writeOut(); });
+#endif
+#if defined(__GLIBC__)
+        cookie_io_functions_t functions{};
+        functions.write = writeCookie;
+        state->cookie = fopencookie(state.get(), "w", functions);
+        if (state->cookie) {
+            std::setvbuf(state->cookie, nullptr, _IONBF, 0);
+            stdout = state->cookie;
+        }
+#endif
+        active = state.get();
+#if defined(ASYNC_OUTPUT_SIGNALS)
+        for (std::size_t i = 0; i < sizeof(signals) / sizeof(signals[0]); ++i) {
+            struct sigaction action{};
+            action.sa_handler = handleSignal;
+            sigemptyset(&action.sa_mask);
+            sigaction(signals[i], &action, &previousActions[i]);
+        }
+#endif
+    }
+
+    AsyncOutput::~AsyncOutput() {
+#if defined(ASYNC_OUTPUT_SIGNALS)
+        for (std::size_t i = 0; i < sizeof(signals) / sizeof(signals[0]); ++i) {
+            sigaction(signals[i], &previousActions[i], nullptr);
+        }
+#endif
+        active = nullptr;
+#if defined(__GLIBC__)
+        if (state->cookie) {
+            std::fflush(state->cookie);
+            stdout = state->out;
+            std::fclose(state->cookie);
+        }
+#endif
+        state->sync();
+        state->stopping.store(true);
+        state->wake();
+        state->thread.join();
+        std::cout.rdbuf(state->coutBuffer);
+    }
+
+    void AsyncOutput::flush() {
+        state->drain();
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+// While one of these exists, what's written to stdout goes into a ring buffer, which a background
+// thread writes out in large batches, so a slow terminal or pipe doesn't hold up the tests (and
+// the reporters) writing to it. std::cout and, with glibc, printf and the rest of C's stdio all go
+// through the one buffer, so everything comes out in the order it was written.
+//
+// Only for writing from the thread that created it, which is why main.cpp doesn't allow
+// --async-output with --threads.
+
+#include <cstddef>
+#include <memory>
+
+namespace extensions {
+
+    class AsyncOutput {
+    public:
+        explicit AsyncOutput(std::size_t capacity = 1 << 20);
+
+        // Writes out what's left first
+        ~AsyncOutput();
+
+        AsyncOutput(AsyncOutput const &) = delete;
+
+        AsyncOutput &operator=(AsyncOutput const &) = delete;
+
+        // Blocks until everything written so far has been written out
+        void flush();
+
+        struct State;
+
+    private:
+        std::unique_ptr<State> state;
+    };
+}
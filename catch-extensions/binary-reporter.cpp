@@ -0,0 +1,104 @@
+// A reporter that writes the results as a compact binary stream (see tools/result-stream.hpp),
+// for CI to turn into JUnit or JSON offline with result-decode.
+//
+// usage: cpp_playground -r binary -o results.bin   (or -o /dev/fd/3, to write to a file descriptor)
+//
+// Like the junit reporter, it captures the tests' stdout and stderr.
+
+#define CATCH_CONFIG_EXTERNAL_INTERFACES
+
+#include "catch.hpp"
+
+#include "tools/result-stream.hpp"
+
+namespace {
+    using results::Event;
+    using results::Record;
+
+    struct BinaryReporter : Catch::StreamingReporterBase<BinaryReporter> {
+        BinaryReporter(Catch::ReporterConfig const &config) : StreamingReporterBase(config) {
+            m_reporterPrefs.shouldRedirectStdOut = true;
+        }
+
+        static std::string getDescription() {
+            return "Reports the results as a length-prefixed binary stream, see result-decode";
+        }
+
+        void testRunStarting(Catch::TestRunInfo const &testRunInfo) override {
+            StreamingReporterBase::testRunStarting(testRunInfo);
+            stream.write(results::magic.data(), static_cast<std::streamsize>(results::magic.size()));
+            Record(Event::RunStarting).string(testRunInfo.name).writeTo(stream);
+        }
+
+        void testCaseStarting(Catch::TestCaseInfo const &testInfo) override {
+            StreamingReporterBase::testCaseStarting(testInfo);
+            Record(Event::TestCaseStarting)
+                    .string(testInfo.name).string(testInfo.lineInfo.file)
+                    .u32(static_cast<std::uint32_t>(testInfo.lineInfo.line)).string(testInfo.tagsAsString())
+                    .writeTo(stream);
+            testCaseTimer.start();
+        }
+
+        void assertionStarting(Catch::AssertionInfo const &) override {}
+
+        bool assertionEnded(Catch::AssertionStats const &assertionStats) override {
+            auto &result = assertionStats.assertionResult;
+            auto outcome = result.isOk() ? results::Outcome::Passed
+                                         : result.getResultType() == Catch::ResultWas::ThrewException ||
+                                           result.getResultType() == Catch::ResultWas::FatalErrorCondition
+                                           ? results::Outcome::Error : results::Outcome::Failed;
+            std::string message;
+            for (auto &info : assertionStats.infoMessages) {
+                message += (message.empty() ? "" : "\n") + info.message;
+            }
+            Record(Event::Assertion)
+                    .u8(static_cast<std::uint8_t>(outcome)).string(static_cast<std::string>(result.getTestMacroName()))
+                    .string(result.getExpression()).string(result.getExpandedExpression()).string(message)
+                    .string(result.getSourceInfo().file).u32(static_cast<std::uint32_t>(result.getSourceInfo().line))
+                    .writeTo(stream);
+            return true;
+        }
+
+        void sectionEnded(Catch::SectionStats const &sectionStats) override {
+            Record(Event::SectionEnded)
+                    .string(sectionStats.sectionInfo.name).f64(sectionStats.durationInSeconds)
+                    .u64(sectionStats.assertions.passed).u64(sectionStats.assertions.failed)
+                    .writeTo(stream);
+            StreamingReporterBase::sectionEnded(sectionStats);
+        }
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+        void benchmarkEnded(Catch::BenchmarkStats<> const &stats) override {
+            Record record(Event::Benchmark);
+            record.string(stats.info.name).u64(static_cast<std::uint64_t>(stats.info.iterations))
+                    .f64(stats.mean.point.count()).f64(stats.mean.lower_bound.count())
+                    .f64(stats.mean.upper_bound.count()).f64(stats.standardDeviation.point.count())
+                    .u32(static_cast<std::uint32_t>(stats.samples.size()));
+            for (auto &sample : stats.samples) {
+                record.f64(sample.count());
+            }
+            record.writeTo(stream);
+        }
+#endif
+
+        void testCaseEnded(Catch::TestCaseStats const &testCaseStats) override {
+            Record(Event::TestCaseEnded)
+                    .f64(testCaseTimer.getElapsedSeconds())
+                    .u64(testCaseStats.totals.assertions.passed).u64(testCaseStats.totals.assertions.failed)
+                    .string(testCaseStats.stdOut).string(testCaseStats.stdErr)
+                    .writeTo(stream);
+            StreamingReporterBase::testCaseEnded(testCaseStats);
+        }
+
+        void testRunEnded(Catch::TestRunStats const &testRunStats) override {
+            Record(Event::RunEnded).u8(testRunStats.aborting).writeTo(stream);
+            stream.flush();
+            StreamingReporterBase::testRunEnded(testRunStats);
+        }
+
+    private:
+        Catch::Timer testCaseTimer;
+    };
+}
+
+CATCH_REGISTER_REPORTER("binary", BinaryReporter)
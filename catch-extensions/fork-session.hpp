@@ -0,0 +1,529 @@
+#pragma once
+
+// Runs test cases in child processes forked from the test executable (--fork), so that what one
+// leaks or leaves behind (globals, files, the heap) doesn't reach the others, and a crash fails the
+// test case rather than ending the run. --fork-batch <n> runs n test cases per process instead of one.
+//
+// Only for main.cpp: it uses Catch's implementation, which is only compiled with CATCH_CONFIG_RUNNER.
+//
+// The children are forked once static initialisation and the command line are done, so they start
+// out with the test registry, the config and the rest already set up, shared copy-on-write with this
+// process, and it only takes a pointer to tell one which test case to run. One child is always
+// forked ahead of time, waiting for its first test case, so running a test case doesn't wait on a
+// fork. A child's reporter writes every event as a record (see tools/result-stream.hpp) to a pipe,
+// and this process replays them into the real reporter once the test case is over, as
+// parallel-session.hpp does for threads. If the child dies half way, the test case fails the way
+// Catch fails one that crashes.
+//
+// POSIX only: elsewhere the test cases run in this process, as usual.
+
+#include "catch.hpp"
+
+#include "tools/result-stream.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <sys/wait.h>
+#include <unistd.h>
+#define FORK_SESSION_POSIX
+#endif
+
+namespace extensions {
+
+    namespace detail {
+
+        enum class ForkEvent : std::uint8_t {
+            TestCaseStarting = 1,
+            SectionStarting,  // section
+            FatalError,       // message
+            AssertionEnded,   // assertion info, result type (u32), message, expansion,
+                              // info messages (a u32 count of macro, line info, type (u32), message, sequence (u32))
+            SectionEnded,     // section, assertions (counts), seconds, missing assertions (u8)
+            TestCaseEnded,    // totals, stdout, stderr, aborting (u8)
+            Ready,            // for the next test case
+            Exiting           // after the last test case of its batch, or a crash Catch handled
+        };
+
+        // The StringRefs and file names of replayed events, which reporters keep until the end of the run
+        inline Catch::StringRef intern(std::string const &string) {
+            static std::unordered_set<std::string> strings;
+            auto const &interned = *strings.insert(string).first;
+            return Catch::StringRef(interned.c_str(), interned.size());
+        }
+
+        inline void writeLineInfo(results::Record &record, Catch::SourceLineInfo const &lineInfo) {
+            record.string(lineInfo.file).u64(lineInfo.line);
+        }
+
+        inline Catch::SourceLineInfo readLineInfo(results::Fields &fields) {
+            auto file = intern(fields.string());
+            return Catch::SourceLineInfo(file.c_str(), static_cast<std::size_t>(fields.u64()));
+        }
+
+        inline void writeCounts(results::Record &record, Catch::Counts const &counts) {
+            record.u64(counts.passed).u64(counts.failed).u64(counts.failedButOk);
+        }
+
+        inline Catch::Counts readCounts(results::Fields &fields) {
+            Catch::Counts counts;
+            counts.passed = fields.u64();
+            counts.failed = fields.u64();
+            counts.failedButOk = fields.u64();
+            return counts;
+        }
+
+        inline void writeTotals(results::Record &record, Catch::Totals const &totals) {
+            record.u32(static_cast<std::uint32_t>(totals.error));
+            writeCounts(record, totals.assertions);
+            writeCounts(record, totals.testCases);
+        }
+
+        inline Catch::Totals readTotals(results::Fields &fields) {
+            Catch::Totals totals;
+            totals.error = static_cast<int>(fields.u32());
+            totals.assertions = readCounts(fields);
+            totals.testCases = readCounts(fields);
+            return totals;
+        }
+
+        inline void writeSection(results::Record &record, Catch::SectionInfo const &section) {
+            record.string(section.name);
+            writeLineInfo(record, section.lineInfo);
+        }
+
+        inline Catch::SectionInfo readSection(results::Fields &fields) {
+            auto name = fields.string();
+            return Catch::SectionInfo(readLineInfo(fields), name);
+        }
+
+#if defined(FORK_SESSION_POSIX)
+
+        inline bool writeAll(int fd, char const *data, std::size_t size) {
+            while (size > 0) {
+                auto written = ::write(fd, data, size);
+                if (written < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (written <= 0) {
+                    return false;
+                }
+                data += written;
+                size -= static_cast<std::size_t>(written);
+            }
+            return true;
+        }
+
+        inline bool readAll(int fd, char *data, std::size_t size) {
+            while (size > 0) {
+                auto n = ::read(fd, data, size);
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (n <= 0) {
+                    return false;
+                }
+                data += n;
+                size -= static_cast<std::size_t>(n);
+            }
+            return true;
+        }
+
+        // One record, without its length; false at the end of the stream
+        inline bool readRecord(int fd, std::string &record) {
+            unsigned char length[4];
+            if (!readAll(fd, reinterpret_cast<char *>(length), sizeof(length))) {
+                return false;
+            }
+            record.resize(length[0] | length[1] << 8 | length[2] << 16 | static_cast<std::size_t>(length[3]) << 24);
+            return readAll(fd, &record[0], record.size());
+        }
+
+        // A child's reporter: writes every event to the pipe as it happens, so the events up to a crash
+        // Catch doesn't handle still get through
+        class ForkReporter : public Catch::IStreamingReporter {
+        public:
+            ForkReporter(Catch::ReporterPreferences preferences, int fd) : preferences(preferences), fd(fd) {}
+
+            Catch::ReporterPreferences getPreferences() const override {
+                return preferences;
+            }
+
+            void noMatchingTestCases(std::string const &) override {}
+
+            void testRunStarting(Catch::TestRunInfo const &) override {}
+
+            void testGroupStarting(Catch::GroupInfo const &) override {}
+
+            void testCaseStarting(Catch::TestCaseInfo const &) override {
+                send(results::Record(static_cast<std::uint8_t>(ForkEvent::TestCaseStarting)));
+            }
+
+            void sectionStarting(Catch::SectionInfo const &sectionInfo) override {
+                results::Record record(static_cast<std::uint8_t>(ForkEvent::SectionStarting));
+                writeSection(record, sectionInfo);
+                send(record);
+            }
+
+            void fatalErrorEncountered(Catch::StringRef name) override {
+                send(results::Record(static_cast<std::uint8_t>(ForkEvent::FatalError)).string(static_cast<std::string>(name)));
+            }
+
+            void assertionStarting(Catch::AssertionInfo const &) override {}
+
+            bool assertionEnded(Catch::AssertionStats const &assertionStats) override {
+                auto const &result = assertionStats.assertionResult;
+                results::Record record(static_cast<std::uint8_t>(ForkEvent::AssertionEnded));
+                record.string(static_cast<std::string>(result.m_info.macroName));
+                writeLineInfo(record, result.m_info.lineInfo);
+                record.string(static_cast<std::string>(result.m_info.capturedExpression))
+                        .u32(static_cast<std::uint32_t>(result.m_info.resultDisposition))
+                        .u32(static_cast<std::uint32_t>(result.m_resultData.resultType))
+                        .string(result.m_resultData.message)
+                        .string(result.m_resultData.reconstructExpression())
+                        .u32(static_cast<std::uint32_t>(assertionStats.infoMessages.size()));
+                for (auto const &info : assertionStats.infoMessages) {
+                    record.string(static_cast<std::string>(info.macroName));
+                    writeLineInfo(record, info.lineInfo);
+                    record.u32(static_cast<std::uint32_t>(info.type)).string(info.message).u32(info.sequence);
+                }
+                writeTotals(record, assertionStats.totals);
+                send(record);
+                return true;
+            }
+
+            void sectionEnded(Catch::SectionStats const &sectionStats) override {
+                results::Record record(static_cast<std::uint8_t>(ForkEvent::SectionEnded));
+                writeSection(record, sectionStats.sectionInfo);
+                writeCounts(record, sectionStats.assertions);
+                record.f64(sectionStats.durationInSeconds).u8(sectionStats.missingAssertions);
+                send(record);
+            }
+
+            void testCaseEnded(Catch::TestCaseStats const &testCaseStats) override {
+                // What the test case wrote goes out before its results are reported
+                std::cout.flush();
+                std::cerr.flush();
+                std::fflush(stdout);
+                std::fflush(stderr);
+                results::Record record(static_cast<std::uint8_t>(ForkEvent::TestCaseEnded));
+                writeTotals(record, testCaseStats.totals);
+                record.string(testCaseStats.stdOut).string(testCaseStats.stdErr).u8(testCaseStats.aborting);
+                send(record);
+            }
+
+            void testGroupEnded(Catch::TestGroupStats const &) override {}
+
+            // Only when Catch handles a crash, as the child exits without ending its run otherwise
+            void testRunEnded(Catch::TestRunStats const &) override {
+                send(results::Record(static_cast<std::uint8_t>(ForkEvent::Exiting)));
+            }
+
+            void skipTest(Catch::TestCaseInfo const &) override {}
+
+            void send(results::Record const &record) {
+                std::string bytes;
+                record.appendTo(bytes);
+                writeAll(fd, bytes.data(), bytes.size());
+            }
+
+        private:
+            Catch::ReporterPreferences preferences;
+            int fd;
+        };
+
+        class ForkedRunner {
+        public:
+            ForkedRunner(std::shared_ptr<Catch::Config> const &config, Catch::ReporterPreferences preferences,
+                         std::size_t batch)
+                    : m_config{config}, m_preferences{preferences}, m_batch{batch} {
+                // A child that died would otherwise take this process with it, when it's sent a test case
+                m_sigpipe = std::signal(SIGPIPE, SIG_IGN);
+            }
+
+            ~ForkedRunner() {
+                finish(m_current);
+                finish(m_spare);
+                std::signal(SIGPIPE, m_sigpipe);
+            }
+
+            ForkedRunner(ForkedRunner const &) = delete;
+
+            ForkedRunner &operator=(ForkedRunner const &) = delete;
+
+            // RunContext::runTest, in a child: replays its events into context's reporter
+            Catch::Totals run(Catch::RunContext &context, Catch::TestCase const &testCase) {
+                // The child has the same address space, so the pointer's good there too
+                auto address = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(&testCase));
+                // What's been reported so far goes out before what the test case writes
+                std::cout.flush();
+                std::fflush(stdout);
+                bool sent = false;
+                for (int attempt = 0; attempt < 2 && !sent; ++attempt) {
+                    if (m_current.pid < 0) {
+                        m_current = m_spare.pid < 0 ? spawn() : m_spare;
+                        m_spare = Worker{};
+                    }
+                    sent = m_current.pid >= 0 &&
+                           writeAll(m_current.commands, reinterpret_cast<char const *>(&address), sizeof(address));
+                    if (!sent) {
+                        // It died without running anything
+                        finish(m_current);
+                    }
+                }
+                if (!sent) {
+                    return context.runTest(testCase);
+                }
+                // Forked while the current child runs its test case
+                if (m_spare.pid < 0) {
+                    m_spare = spawn();
+                }
+
+                std::vector<std::string> records;
+                bool ended = false;
+                bool exiting = false;
+                std::string record;
+                while (readRecord(m_current.results, record)) {
+                    auto event = static_cast<ForkEvent>(record[0]);
+                    if (event == ForkEvent::Ready || event == ForkEvent::Exiting) {
+                        exiting = event == ForkEvent::Exiting;
+                        break;
+                    }
+                    ended = ended || event == ForkEvent::TestCaseEnded;
+                    records.push_back(std::move(record));
+                }
+                int status = 0;
+                if (!ended || exiting) {
+                    status = finish(m_current);
+                }
+                return replay(context, testCase, records, ended, status);
+            }
+
+        private:
+            struct Worker {
+                pid_t pid = -1;
+                int commands = -1;
+                int results = -1;
+            };
+
+            std::shared_ptr<Catch::Config> m_config;
+            Catch::ReporterPreferences m_preferences;
+            std::size_t m_batch;
+            Worker m_current;
+            Worker m_spare;
+            void (*m_sigpipe)(int);
+
+            Worker spawn() {
+                int commands[2];
+                int results[2];
+                if (pipe(commands) != 0) {
+                    return Worker{};
+                }
+                if (pipe(results) != 0) {
+                    close(commands[0]);
+                    close(commands[1]);
+                    return Worker{};
+                }
+                // Or the child writes out this process's buffered output too
+                std::cout.flush();
+                std::cerr.flush();
+                std::fflush(stdout);
+                std::fflush(stderr);
+                auto pid = fork();
+                if (pid == 0) {
+                    close(commands[1]);
+                    close(results[0]);
+                    // Keeping the other children's pipes open would keep them from seeing the end of theirs
+                    for (auto worker : {m_current, m_spare}) {
+                        if (worker.pid >= 0) {
+                            close(worker.commands);
+                            close(worker.results);
+                        }
+                    }
+                    runChild(commands[0], results[1]);
+                }
+                close(commands[0]);
+                close(results[1]);
+                if (pid < 0) {
+                    close(commands[1]);
+                    close(results[0]);
+                    return Worker{};
+                }
+                return Worker{pid, commands[1], results[0]};
+            }
+
+            [[noreturn]] void runChild(int commands, int results) {
+                auto reporter = new ForkReporter(m_preferences, results);
+                Catch::RunContext context(m_config, Catch::IStreamingReporterPtr(reporter));
+                for (std::size_t ran = 0; ran < m_batch; ++ran) {
+                    std::uint64_t address;
+                    if (!readAll(commands, reinterpret_cast<char *>(&address), sizeof(address))) {
+                        break;
+                    }
+                    context.runTest(*reinterpret_cast<Catch::TestCase const *>(static_cast<std::uintptr_t>(address)));
+                    reporter->send(results::Record(static_cast<std::uint8_t>(
+                            ran + 1 < m_batch ? ForkEvent::Ready : ForkEvent::Exiting)));
+                }
+                // Without this process's static destructors, atexit handlers or stdio buffers
+                _exit(0);
+            }
+
+            // Waits for the child to exit, once it's done or has died
+            int finish(Worker &worker) {
+                if (worker.pid < 0) {
+                    return 0;
+                }
+                close(worker.commands);
+                close(worker.results);
+                int status = 0;
+                while (waitpid(worker.pid, &status, 0) < 0 && errno == EINTR) {
+                }
+                worker = Worker{};
+                return status;
+            }
+
+            // Replays the child's events. A test case that didn't end (the child died) fails the way
+            // Catch fails one that crashes (see RunContext::handleFatalErrorCondition), and sections
+            // that didn't end (Catch doesn't end them when it handles a crash) are ended first
+            static Catch::Totals replay(Catch::RunContext &context, Catch::TestCase const &testCase,
+                                        std::vector<std::string> const &records, bool ended, int status) {
+                auto &reporter = context.reporter();
+                std::vector<Catch::SectionInfo> sections;
+                auto endSections = [&](std::size_t remaining) {
+                    for (; sections.size() > remaining; sections.pop_back()) {
+                        reporter.sectionEnded(Catch::SectionStats(sections.back(), Catch::Counts{}, 0, false));
+                    }
+                };
+                bool started = false;
+                Catch::Totals totals;
+                for (auto const &record : records) {
+                    results::Fields fields(record.data() + 1, record.size() - 1);
+                    switch (static_cast<ForkEvent>(record[0])) {
+                        case ForkEvent::TestCaseStarting:
+                            reporter.testCaseStarting(testCase);
+                            started = true;
+                            break;
+                        case ForkEvent::SectionStarting:
+                            sections.push_back(readSection(fields));
+                            reporter.sectionStarting(sections.back());
+                            break;
+                        case ForkEvent::FatalError:
+                            reporter.fatalErrorEncountered(intern(fields.string()));
+                            break;
+                        case ForkEvent::AssertionEnded: {
+                            auto macroName = intern(fields.string());
+                            auto lineInfo = readLineInfo(fields);
+                            auto capturedExpression = intern(fields.string());
+                            auto disposition = static_cast<Catch::ResultDisposition::Flags>(fields.u32());
+                            Catch::AssertionInfo info{macroName, lineInfo, capturedExpression, disposition};
+
+                            Catch::AssertionResultData data(static_cast<Catch::ResultWas::OfType>(fields.u32()),
+                                                            Catch::LazyExpression(false));
+                            data.message = fields.string();
+                            data.reconstructedExpression = fields.string();
+
+                            std::vector<Catch::MessageInfo> infoMessages;
+                            for (auto count = fields.u32(); count > 0; --count) {
+                                auto infoMacroName = intern(fields.string());
+                                auto infoLineInfo = readLineInfo(fields);
+                                Catch::MessageInfo message(infoMacroName, infoLineInfo,
+                                                           static_cast<Catch::ResultWas::OfType>(fields.u32()));
+                                message.message = fields.string();
+                                message.sequence = fields.u32();
+                                infoMessages.push_back(message);
+                            }
+                            Catch::AssertionStats stats(Catch::AssertionResult(info, data), infoMessages,
+                                                        readTotals(fields));
+                            // The constructor appends the result's message to the info messages (again)
+                            stats.infoMessages = infoMessages;
+                            reporter.assertionEnded(stats);
+                            break;
+                        }
+                        case ForkEvent::SectionEnded: {
+                            auto section = readSection(fields);
+                            auto assertions = readCounts(fields);
+                            auto seconds = fields.f64();
+                            reporter.sectionEnded(Catch::SectionStats(section, assertions, seconds, fields.u8() != 0));
+                            if (!sections.empty()) {
+                                sections.pop_back();
+                            }
+                            break;
+                        }
+                        case ForkEvent::TestCaseEnded: {
+                            endSections(0);
+                            totals = readTotals(fields);
+                            auto stdOut = fields.string();
+                            auto stdErr = fields.string();
+                            reporter.testCaseEnded(Catch::TestCaseStats(testCase, totals, stdOut, stdErr, fields.u8() != 0));
+                            break;
+                        }
+                        default:
+                            break;
+                    }
+                }
+
+                if (!ended) {
+                    if (!started) {
+                        reporter.testCaseStarting(testCase);
+                    }
+                    if (sections.empty()) {
+                        sections.emplace_back(testCase.lineInfo, testCase.name);
+                        reporter.sectionStarting(sections.back());
+                    }
+                    std::string message;
+                    if (WIFSIGNALED(status)) {
+                        message = "child process killed by signal " + std::to_string(WTERMSIG(status)) + " ("
+                                  + strsignal(WTERMSIG(status)) + ")";
+                    } else {
+                        message = "child process exited with status " + std::to_string(WEXITSTATUS(status))
+                                  + " during the test case";
+                    }
+                    reporter.fatalErrorEncountered(intern(message));
+
+                    Catch::AssertionInfo info{""_catch_sr, sections.back().lineInfo,
+                                              "{Unknown expression after the reported line}"_catch_sr,
+                                              Catch::ResultDisposition::Normal};
+                    Catch::AssertionResultData data(Catch::ResultWas::FatalErrorCondition, Catch::LazyExpression(false));
+                    data.message = message;
+                    totals = Catch::Totals{};
+                    totals.testCases.failed = 1;
+                    totals.assertions.failed = 1;
+                    reporter.assertionEnded(Catch::AssertionStats(Catch::AssertionResult(info, data), {}, totals));
+
+                    endSections(1);
+                    Catch::Counts assertions;
+                    assertions.failed = 1;
+                    reporter.sectionEnded(Catch::SectionStats(sections.back(), assertions, 0, false));
+                    reporter.testCaseEnded(Catch::TestCaseStats(testCase, totals, "", "", false));
+                }
+                context.addTotals(totals);
+                return totals;
+            }
+        };
+
+#else
+
+        class ForkedRunner {
+        public:
+            ForkedRunner(std::shared_ptr<Catch::Config> const &, Catch::ReporterPreferences, std::size_t) {
+                Catch::cerr() << "--fork: only available on POSIX systems, running the test cases in this process"
+                              << std::endl;
+            }
+
+            Catch::Totals run(Catch::RunContext &context, Catch::TestCase const &testCase) {
+                return context.runTest(testCase);
+            }
+        };
+
+#endif
+    }
+}
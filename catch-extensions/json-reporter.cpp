@@ -0,0 +1,78 @@
+// A reporter that writes benchmark results as JSON, for tools/bench-compare.cpp to compare runs.
+//
+// usage: cpp_playground_bench -r json -o results.json
+
+#include "catch.hpp"
+
+#include "tools/json.hpp"
+
+#include <vector>
+
+namespace {
+    struct JsonReporter : Catch::StreamingReporterBase<JsonReporter> {
+        using StreamingReporterBase::StreamingReporterBase;
+
+        static std::string getDescription() {
+            return "Reports benchmark results as JSON";
+        }
+
+        void assertionStarting(Catch::AssertionInfo const &) override {}
+
+        bool assertionEnded(Catch::AssertionStats const &) override {
+            return true;
+        }
+
+        void benchmarkEnded(Catch::BenchmarkStats<> const &stats) override {
+            results.push_back({currentTestCaseInfo->name, stats});
+        }
+
+        void testRunEnded(Catch::TestRunStats const &testRunStats) override {
+            auto precision = stream.precision(12);
+            stream << "{\n"
+                   << "  \"confidence_interval\": " << m_config->benchmarkConfidenceInterval() << ",\n"
+                   << "  \"benchmarks\": [";
+            for (std::size_t i = 0; i < results.size(); ++i) {
+                auto &stats = results[i].stats;
+                stream << (i == 0 ? "\n" : ",\n")
+                       << "    {\n"
+                       << "      \"name\": \"" << json::escape(stats.info.name) << "\",\n"
+                       << "      \"test_case\": \"" << json::escape(results[i].testCase) << "\",\n"
+                       << "      \"samples\": " << stats.info.samples << ",\n"
+                       << "      \"iterations\": " << stats.info.iterations << ",\n"
+                       << "      \"mean\": " << Estimate{stats.mean} << ",\n"
+                       << "      \"standard_deviation\": " << Estimate{stats.standardDeviation} << ",\n"
+                       << "      \"outliers\": {"
+                       << "\"low_severe\": " << stats.outliers.low_severe << ", "
+                       << "\"low_mild\": " << stats.outliers.low_mild << ", "
+                       << "\"high_mild\": " << stats.outliers.high_mild << ", "
+                       << "\"high_severe\": " << stats.outliers.high_severe << "},\n"
+                       << "      \"outlier_variance\": " << stats.outlierVariance << "\n"
+                       << "    }";
+            }
+            stream << "\n  ]\n}\n";
+            stream.precision(precision);
+            StreamingReporterBase::testRunEnded(testRunStats);
+        }
+
+    private:
+        struct Result {
+            std::string testCase;
+            Catch::BenchmarkStats<> stats;
+        };
+
+        std::vector<Result> results;
+
+        // Durations are written in nanoseconds
+        struct Estimate {
+            Catch::Benchmark::Estimate<Catch::Benchmark::FloatDuration<Catch::Benchmark::default_clock>> const &e;
+
+            friend std::ostream &operator<<(std::ostream &os, Estimate const &estimate) {
+                return os << "{\"point\": " << estimate.e.point.count()
+                          << ", \"lower_bound\": " << estimate.e.lower_bound.count()
+                          << ", \"upper_bound\": " << estimate.e.upper_bound.count() << "}";
+            }
+        };
+    };
+}
+
+CATCH_REGISTER_REPORTER("json", JsonReporter)
@@ -0,0 +1,42 @@
+#pragma once
+
+// Command line options main.cpp adds on top of Catch's own, for the listeners and reporters
+// in catch-extensions/ to read.
+
+#include <string>
+
+namespace extensions {
+
+    struct Options {
+        // --record: where test-record.cpp writes each test case's duration and result
+        std::string recordFile;
+        // --threads: how many threads parallel-session.hpp runs the [parallel] test cases on (0: off),
+        // and GENERATE_PARALLEL runs its body on (see parallel-generate.hpp)
+        unsigned threads = 0;
+        // --history: the test history (see tools/test-history.hpp) test-record.cpp updates after the run
+        std::string historyFile;
+        // --order-by-history: run the test cases likeliest to fail first, then the shortest first
+        bool orderByHistory = false;
+        // --cache: skip the test cases that passed before and whose sources haven't changed (see tools/test-cache.hpp)
+        std::string cacheFile;
+        // --run-all: run them anyway, but still update the cache
+        bool runAll = false;
+        // --allocations: report what every test case and section allocated (see allocations.cpp)
+        bool allocations = false;
+        // --perf: report hardware performance counters, with the perf-console/perf-xml reporters (see perf-counters.cpp)
+        bool perf = false;
+        // --async-output: write stdout from a background thread (see async-output.hpp)
+        bool asyncOutput = false;
+        // --capture: capture each test case's stdout and stderr, and only show failing ones' (see output-capture.hpp)
+        bool capture = false;
+        // --fork: run the test cases in child processes (see fork-session.hpp)
+        bool fork = false;
+        // --fork-batch: how many test cases each child runs
+        unsigned forkBatch = 1;
+    };
+
+    inline Options &options() {
+        static Options instance;
+        return instance;
+    }
+}
@@ -0,0 +1,233 @@
+// The capture behind output-capture.hpp, which Catch's RunContext starts and stops around every
+// test case through Catch::Detail::outputCapture().
+//
+// stdout and stderr (file descriptors 1 and 2) are pointed at a memfd each while a test case runs,
+// and read back afterwards, so there are no files and no threads involved. Without memfds, they're
+// pointed at pipes instead, which a thread reads from, so a test case can write more than a pipe holds.
+// In between test cases std::cout writes straight to the real stdout: that's what the reporters
+// write to.
+
+#include "catch.hpp"
+
+#include "output-capture.hpp"
+
+#include <cstdio>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define OUTPUT_CAPTURE_POSIX
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#if defined(OUTPUT_CAPTURE_POSIX)
+
+namespace {
+    void writeAll(int fd, const char *data, std::size_t size) {
+        while (size > 0) {
+            auto written = ::write(fd, data, size);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                return;
+            }
+            data += written;
+            size -= static_cast<std::size_t>(written);
+        }
+    }
+
+    // What std::cout writes to between test cases
+    class FdBuffer : public std::streambuf {
+    public:
+        explicit FdBuffer(int fd) : fd(fd) {
+            setp(buffer, buffer + sizeof(buffer));
+        }
+
+    protected:
+        int sync() override {
+            writeAll(fd, pbase(), static_cast<std::size_t>(pptr() - pbase()));
+            setp(buffer, buffer + sizeof(buffer));
+            return 0;
+        }
+
+        int_type overflow(int_type c) override {
+            sync();
+            if (!traits_type::eq_int_type(c, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(c);
+                pbump(1);
+            }
+            return traits_type::not_eof(c);
+        }
+
+    private:
+        int fd;
+        char buffer[8 * 1024];
+    };
+
+    // Captures what's written to one file descriptor, 1 or 2
+    class Capture {
+    public:
+        explicit Capture(int target) : target(target) {
+#if defined(__linux__)
+            memfd = memfd_create(target == 1 ? "stdout" : "stderr", MFD_CLOEXEC);
+#endif
+        }
+
+        ~Capture() {
+            if (memfd >= 0) {
+                close(memfd);
+            }
+        }
+
+        Capture(Capture const &) = delete;
+
+        Capture &operator=(Capture const &) = delete;
+
+        void start() {
+            if (memfd >= 0) {
+                ftruncate(memfd, 0);
+                lseek(memfd, 0, SEEK_SET);
+                dup2(memfd, target);
+                return;
+            }
+            int fds[2];
+            if (pipe(fds) != 0) {
+                return;
+            }
+            fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+            reader = std::thread([this, in = fds[0]] {
+                char buffer[4096];
+                for (;;) {
+                    auto n = ::read(in, buffer, sizeof(buffer));
+                    if (n < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if (n <= 0) {
+                        break;
+                    }
+                    piped.append(buffer, static_cast<std::size_t>(n));
+                }
+                close(in);
+            });
+            dup2(fds[1], target);
+            close(fds[1]);
+        }
+
+        // realFd being the original target
+        void stop(int realFd, std::string &captured) {
+            dup2(realFd, target);
+            if (memfd >= 0) {
+                struct stat status{};
+                fstat(memfd, &status);
+                auto offset = captured.size();
+                captured.resize(offset + static_cast<std::size_t>(status.st_size));
+                std::size_t read = 0;
+                while (read < static_cast<std::size_t>(status.st_size)) {
+                    auto n = pread(memfd, &captured[offset + read], static_cast<std::size_t>(status.st_size) - read,
+                                   static_cast<off_t>(read));
+                    if (n <= 0) {
+                        break;
+                    }
+                    read += static_cast<std::size_t>(n);
+                }
+                captured.resize(offset + read);
+            } else if (reader.joinable()) {
+                // Restoring the target closed the pipe's last write end, so the reader is done soon
+                reader.join();
+                captured += piped;
+                piped.clear();
+            }
+        }
+
+    private:
+        int target;
+        int memfd = -1;
+        std::thread reader;
+        std::string piped;
+    };
+}
+
+namespace extensions {
+
+    struct OutputCapture::State : Catch::Detail::IOutputCapture {
+        int realStdout = dup(1);
+        int realStderr = dup(2);
+        FdBuffer reporterBuffer{realStdout};
+        std::streambuf *coutBuffer = nullptr;
+        Capture out{1};
+        Capture err{2};
+        bool capturing = false;
+
+        State() {
+            fcntl(realStdout, F_SETFD, FD_CLOEXEC);
+            fcntl(realStderr, F_SETFD, FD_CLOEXEC);
+        }
+
+        ~State() override {
+            close(realStdout);
+            close(realStderr);
+        }
+
+        void start() override {
+            std::cout.flush();
+            std::fflush(stdout);
+            std::fflush(stderr);
+            std::cout.rdbuf(coutBuffer);
+            out.start();
+            err.start();
+            capturing = true;
+        }
+
+        void stop(std::string &redirectedCout, std::string &redirectedCerr) override {
+            if (!capturing) {
+                return;
+            }
+            capturing = false;
+            std::cout.flush();
+            std::cerr.flush();
+            std::clog.flush();
+            std::fflush(stdout);
+            std::fflush(stderr);
+            out.stop(realStdout, redirectedCout);
+            err.stop(realStderr, redirectedCerr);
+            std::cout.rdbuf(&reporterBuffer);
+        }
+    };
+
+    OutputCapture::OutputCapture() : state(new State) {
+        std::cout.flush();
+        state->coutBuffer = std::cout.rdbuf(&state->reporterBuffer);
+        Catch::Detail::outputCapture() = state.get();
+    }
+
+    OutputCapture::~OutputCapture() {
+        Catch::Detail::outputCapture() = nullptr;
+        std::cout.flush();
+        std::cout.rdbuf(state->coutBuffer);
+    }
+}
+
+#else
+
+namespace extensions {
+
+    struct OutputCapture::State {};
+
+    OutputCapture::OutputCapture() {
+        Catch::cerr() << "--capture: only available on POSIX systems" << std::endl;
+    }
+
+    OutputCapture::~OutputCapture() = default;
+}
+
+#endif
@@ -0,0 +1,29 @@
+#pragma once
+
+// While one of these exists, each test case's stdout and stderr (std::cout and printf alike) are
+// captured in memory, and only shown, or put in the report, for the test cases that fail. The
+// reporters still write to the real stdout.
+//
+// Captures at the file descriptor level, into memfds on Linux and through pipes elsewhere, which
+// is for the whole process: main.cpp doesn't allow --capture with --threads.
+
+#include <memory>
+
+namespace extensions {
+
+    class OutputCapture {
+    public:
+        OutputCapture();
+
+        ~OutputCapture();
+
+        OutputCapture(OutputCapture const &) = delete;
+
+        OutputCapture &operator=(OutputCapture const &) = delete;
+
+        struct State;
+
+    private:
+        std::unique_ptr<State> state;
+    };
+}
@@ -0,0 +1,386 @@
+#pragma once
+
+// Runs a test body once per value of a generator, with the values spread over a pool of threads:
+//
+//   GENERATE_PARALLEL(range(0, 100000), [](int i) {
+//       CHECK(add(i, -i) == 0);
+//   });
+//
+// Where GENERATE re-runs the whole test case for every value, one at a time, this runs only the
+// body, on as many threads as --threads says, or std::thread::hardware_concurrency() (the calling
+// one included). Every thread records the failing assertions (and with -s the passing ones) per
+// value, and only counts the passing ones; the calling thread then reports them in the order of
+// the values, each with the value it failed for, so the output reads like a serial run.
+//
+// The body mustn't have side effects other values' runs can see. It can't use SECTION, GENERATE or
+// BENCHMARK, and its std::cout output isn't captured. A failing REQUIRE ends the body for that value
+// only; the test case ends once all of them have been reported.
+
+#include "catch.hpp"
+
+#include "options.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace extensions {
+
+    namespace detail {
+
+        // An expression whose result and expansion were worked out on another thread
+        class RecordedExpression : public Catch::ITransientExpression {
+        public:
+            RecordedExpression(bool isBinaryExpression, bool result, std::string const &expansion)
+                    : ITransientExpression{isBinaryExpression, result}, expansion(expansion) {}
+
+            void streamReconstructedExpression(std::ostream &os) const override {
+                os << expansion;
+            }
+
+        private:
+            std::string const &expansion;
+        };
+
+        // One assertion made on a worker thread, for reporting on the calling thread
+        struct RecordedAssertion {
+            enum class Kind {
+                Expression, Message, NonExpression, Exception, Incomplete
+            };
+
+            std::size_t value;
+            Kind kind;
+            Catch::AssertionInfo info;
+            Catch::ResultWas::OfType type = Catch::ResultWas::Unknown;
+            // Expression only
+            bool isBinaryExpression = false;
+            bool result = false;
+            // The expression's expansion, or the message
+            std::string text;
+            // The INFOs, CAPTUREs and UNSCOPED_INFOs in scope
+            std::vector<Catch::MessageInfo> messages;
+        };
+
+        // The IResultCapture of a thread running GENERATE_PARALLEL's body
+        class RecordingCapture : public Catch::IResultCapture {
+        public:
+            RecordingCapture(Catch::IResultCapture &real, Catch::AssertionInfo const &generatorInfo, bool includeSuccessful)
+                    : real(real), generatorInfo(generatorInfo), includeSuccessful(includeSuccessful),
+                      testName(real.getCurrentTestName()) {}
+
+            std::vector<RecordedAssertion> recorded;
+            std::size_t passed = 0;
+
+            // Runs the body for one value, catching what ends it early
+            template<typename Body, typename T>
+            void run(std::size_t index, Body &body, T const &value) {
+                current = index;
+                try {
+                    body(value);
+                } catch (Catch::TestFailureException &) {
+                    // A REQUIRE failed, and was recorded
+                } catch (...) {
+                    record(RecordedAssertion::Kind::Exception, generatorInfo, Catch::ResultWas::ThrewException,
+                           Catch::translateActiveException());
+                }
+                scoped.clear();
+                unscoped.clear();
+            }
+
+            bool sectionStarted(Catch::SectionInfo const &, Catch::Counts &) override {
+                throw std::logic_error("SECTION can't be used in GENERATE_PARALLEL's body");
+            }
+
+            void sectionEnded(Catch::SectionEndInfo const &) override {}
+
+            void sectionEndedEarly(Catch::SectionEndInfo const &) override {}
+
+            auto acquireGeneratorTracker(Catch::SourceLineInfo const &) -> Catch::IGeneratorTracker & override {
+                throw std::logic_error("GENERATE can't be used in GENERATE_PARALLEL's body");
+            }
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+            void benchmarkPreparing(std::string const &) override {
+                throw std::logic_error("BENCHMARK can't be used in GENERATE_PARALLEL's body");
+            }
+
+            void benchmarkStarting(Catch::BenchmarkInfo const &) override {}
+
+            void benchmarkEnded(Catch::BenchmarkStats<> const &) override {}
+
+            void benchmarkFailed(std::string const &) override {}
+#endif
+
+            void pushScopedMessage(Catch::MessageInfo const &message) override {
+                scoped.push_back(message);
+            }
+
+            void popScopedMessage(Catch::MessageInfo const &message) override {
+                auto it = std::find(scoped.rbegin(), scoped.rend(), message);
+                if (it != scoped.rend()) {
+                    scoped.erase(std::next(it).base());
+                }
+            }
+
+            void emplaceUnscopedMessage(Catch::MessageBuilder const &builder) override {
+                unscoped.push_back(builder.m_info);
+                unscoped.back().message = builder.m_stream.str();
+            }
+
+            // A crash takes the whole run down, the real RunContext reports it
+            void handleFatalErrorCondition(Catch::StringRef message) override {
+                real.handleFatalErrorCondition(message);
+            }
+
+            void handleExpr(Catch::AssertionInfo const &info, Catch::ITransientExpression const &expr,
+                            Catch::AssertionReaction &reaction) override {
+                bool result = expr.getResult() != Catch::isFalseTest(info.resultDisposition);
+                if (result && !includeSuccessful) {
+                    assertionPassed();
+                    return;
+                }
+                std::ostringstream expansion;
+                expr.streamReconstructedExpression(expansion);
+                auto &assertion = record(RecordedAssertion::Kind::Expression, info,
+                                         result ? Catch::ResultWas::Ok : Catch::ResultWas::ExpressionFailed,
+                                         expansion.str());
+                assertion.isBinaryExpression = expr.isBinaryExpression();
+                assertion.result = expr.getResult();
+                react(result, info, reaction);
+            }
+
+            void handleMessage(Catch::AssertionInfo const &info, Catch::ResultWas::OfType resultType,
+                               Catch::StringRef const &message, Catch::AssertionReaction &reaction) override {
+                record(RecordedAssertion::Kind::Message, info, resultType, static_cast<std::string>(message));
+                react(Catch::isOk(resultType), info, reaction);
+            }
+
+            void handleUnexpectedExceptionNotThrown(Catch::AssertionInfo const &info,
+                                                    Catch::AssertionReaction &reaction) override {
+                handleNonExpr(info, Catch::ResultWas::DidntThrowException, reaction);
+            }
+
+            void handleUnexpectedInflightException(Catch::AssertionInfo const &info, std::string const &message,
+                                                   Catch::AssertionReaction &reaction) override {
+                record(RecordedAssertion::Kind::Exception, info, Catch::ResultWas::ThrewException, message);
+                react(false, info, reaction);
+            }
+
+            void handleIncomplete(Catch::AssertionInfo const &info) override {
+                record(RecordedAssertion::Kind::Incomplete, info, Catch::ResultWas::ThrewException, {});
+            }
+
+            void handleNonExpr(Catch::AssertionInfo const &info, Catch::ResultWas::OfType resultType,
+                               Catch::AssertionReaction &reaction) override {
+                bool result = Catch::isOk(resultType);
+                if (result && !includeSuccessful) {
+                    assertionPassed();
+                    return;
+                }
+                record(RecordedAssertion::Kind::NonExpression, info, resultType, {});
+                react(result, info, reaction);
+            }
+
+            bool lastAssertionPassed() override {
+                return lastPassed;
+            }
+
+            void assertionPassed() override {
+                lastPassed = true;
+                ++passed;
+                unscoped.clear();
+            }
+
+            std::string getCurrentTestName() const override {
+                return testName;
+            }
+
+            const Catch::AssertionResult *getLastResult() const override {
+                return nullptr;
+            }
+
+            void exceptionEarlyReported() override {}
+
+        private:
+            RecordedAssertion &record(RecordedAssertion::Kind kind, Catch::AssertionInfo const &info,
+                                      Catch::ResultWas::OfType type, std::string text) {
+                std::vector<Catch::MessageInfo> messages = scoped;
+                messages.insert(messages.end(), unscoped.begin(), unscoped.end());
+                recorded.push_back({current, kind, info, type, false, false, std::move(text), std::move(messages)});
+                auto &assertion = recorded.back();
+                unscoped.clear();
+                return assertion;
+            }
+
+            void react(bool result, Catch::AssertionInfo const &info, Catch::AssertionReaction &reaction) {
+                lastPassed = result;
+                if (!result) {
+                    reaction.shouldThrow = (info.resultDisposition & Catch::ResultDisposition::Normal) != 0;
+                }
+            }
+
+            Catch::IResultCapture &real;
+            Catch::AssertionInfo generatorInfo;
+            bool includeSuccessful;
+            std::string testName;
+            std::size_t current = 0;
+            bool lastPassed = true;
+            std::vector<Catch::MessageInfo> scoped;
+            std::vector<Catch::MessageInfo> unscoped;
+        };
+
+        // Pushes messages onto the real capture for one assertion, and pops them even if it throws
+        class ReplayedMessages {
+        public:
+            ReplayedMessages(Catch::IResultCapture &capture, std::vector<Catch::MessageInfo> messages)
+                    : capture(capture), messages(std::move(messages)) {
+                for (auto &message : this->messages) {
+                    capture.pushScopedMessage(message);
+                }
+            }
+
+            ~ReplayedMessages() {
+                for (auto it = messages.rbegin(); it != messages.rend(); ++it) {
+                    capture.popScopedMessage(*it);
+                }
+            }
+
+            ReplayedMessages(ReplayedMessages const &) = delete;
+
+            ReplayedMessages &operator=(ReplayedMessages const &) = delete;
+
+        private:
+            Catch::IResultCapture &capture;
+            std::vector<Catch::MessageInfo> messages;
+        };
+
+        // A copy made on this thread, so its sequence number is one the real capture hasn't seen
+        inline Catch::MessageInfo copyMessage(Catch::MessageInfo const &message) {
+            Catch::MessageInfo copy(message.macroName, message.lineInfo, message.type);
+            copy.message = message.message;
+            return copy;
+        }
+
+        // Reports one recorded assertion to the real capture, returning whether it asks to stop the test case
+        inline bool replay(Catch::IResultCapture &capture, RecordedAssertion const &assertion) {
+            Catch::AssertionReaction reaction;
+            switch (assertion.kind) {
+                case RecordedAssertion::Kind::Expression:
+                    capture.handleExpr(assertion.info,
+                                       RecordedExpression{assertion.isBinaryExpression, assertion.result, assertion.text},
+                                       reaction);
+                    break;
+                case RecordedAssertion::Kind::Message:
+                    capture.handleMessage(assertion.info, assertion.type, assertion.text, reaction);
+                    break;
+                case RecordedAssertion::Kind::NonExpression:
+                    capture.handleNonExpr(assertion.info, assertion.type, reaction);
+                    break;
+                case RecordedAssertion::Kind::Exception:
+                    capture.handleUnexpectedInflightException(assertion.info, assertion.text, reaction);
+                    break;
+                case RecordedAssertion::Kind::Incomplete:
+                    capture.handleIncomplete(assertion.info);
+                    break;
+            }
+            return reaction.shouldThrow;
+        }
+
+        // Runs the body for every value the generator produces, see GENERATE_PARALLEL
+        template<typename T, typename Body>
+        void generateParallel(Catch::AssertionInfo const &info, Catch::Generators::GeneratorWrapper<T> &&generator,
+                              Body &&body) {
+            std::vector<T> values;
+            do {
+                values.push_back(generator.get());
+            } while (generator.next());
+
+            auto &context = Catch::getCurrentMutableContext();
+            auto &real = *context.getResultCapture();
+            auto config = context.getConfig();
+            bool includeSuccessful = config && config->includeSuccessfulResults();
+
+            auto threads = options().threads > 0 ? options().threads : std::thread::hardware_concurrency();
+            threads = std::max<std::size_t>(1, std::min<std::size_t>(threads, values.size()));
+            // Chunks small enough to even out bodies that take longer for some values
+            auto chunk = std::max<std::size_t>(1, values.size() / (threads * 16));
+            std::atomic<std::size_t> next{0};
+            std::vector<RecordingCapture> captures(threads, RecordingCapture{real, info, includeSuccessful});
+            auto work = [&](RecordingCapture &capture) {
+                for (auto begin = next.fetch_add(chunk); begin < values.size(); begin = next.fetch_add(chunk)) {
+                    for (auto index = begin; index < std::min(begin + chunk, values.size()); ++index) {
+                        capture.run(index, body, values[index]);
+                    }
+                }
+            };
+
+            std::vector<std::thread> workers;
+            for (std::size_t worker = 1; worker < threads; ++worker) {
+                workers.emplace_back([&, worker] {
+                    auto &workerContext = Catch::getCurrentMutableContext();
+                    workerContext.setConfig(config);
+                    workerContext.setResultCapture(&captures[worker]);
+                    work(captures[worker]);
+                    Catch::cleanUpContext();
+                });
+            }
+            // The calling thread is one of the workers, with its own capture swapped out while it is
+            context.setResultCapture(&captures[0]);
+            work(captures[0]);
+            context.setResultCapture(&real);
+            for (auto &worker : workers) {
+                worker.join();
+            }
+
+            std::vector<RecordedAssertion> recorded;
+            std::size_t passed = 0;
+            for (auto &capture : captures) {
+                std::move(capture.recorded.begin(), capture.recorded.end(), std::back_inserter(recorded));
+                passed += capture.passed;
+            }
+            // Each value ran on one thread, so this keeps its assertions in the order they were made
+            std::stable_sort(recorded.begin(), recorded.end(), [](RecordedAssertion const &a, RecordedAssertion const &b) {
+                return a.value < b.value;
+            });
+
+            bool required = false;
+            for (auto &assertion : recorded) {
+                Catch::MessageInfo value(info.macroName, info.lineInfo, Catch::ResultWas::Info);
+                value.message = "value " + std::to_string(assertion.value) + " := " + Catch::Detail::stringify(values[assertion.value]);
+                std::vector<Catch::MessageInfo> messages{value};
+                for (auto &message : assertion.messages) {
+                    messages.push_back(copyMessage(message));
+                }
+                ReplayedMessages replayed(real, std::move(messages));
+                if (replay(real, assertion)) {
+                    required = true;
+                    // A CHECK asking to stop means the run is aborting (--abort)
+                    if (!(assertion.info.resultDisposition & Catch::ResultDisposition::Normal)) {
+                        throw Catch::TestFailureException();
+                    }
+                }
+            }
+            for (std::size_t i = 0; i < passed; ++i) {
+                real.assertionPassed();
+            }
+            if (required) {
+                throw Catch::TestFailureException();
+            }
+        }
+    }
+}
+
+// GENERATE_PARALLEL(generator, body): the generator being one of Catch::Generators' (range, values,
+// random, map, filter, ...), wrapped in parentheses if it has commas outside of any (e.g. table<int, int>)
+#define GENERATE_PARALLEL(generator, ...) \
+    ::extensions::detail::generateParallel( \
+        ::Catch::AssertionInfo{"GENERATE_PARALLEL"_catch_sr, CATCH_INTERNAL_LINEINFO, #generator, \
+                               ::Catch::ResultDisposition::Normal}, \
+        [&] { using namespace ::Catch::Generators; return generator; }(), __VA_ARGS__)
@@ -0,0 +1,373 @@
+#pragma once
+
+// Runs the test cases tagged [parallel] on a pool of threads, in the same process (--threads <n>),
+// and/or in an order of our own (--order-by-history), leaving out some of them (--cache).
+//
+// Only for main.cpp: it uses Catch's implementation, which is only compiled with CATCH_CONFIG_RUNNER.
+//
+// Every worker thread has its own RunContext, and with it its own Catch context, assertion handling
+// and string stream pool. Its reporter only records the events of the test case it's running; the
+// main thread replays them into the real reporter in declaration order, so the output reads like a
+// serial run. Test cases without the tag run on the main thread, in between, as usual.
+//
+// A [parallel] test case mustn't share mutable state with other test cases, and it can't rely on its
+// std::cout output being captured (e.g. by the junit reporter) or on surviving a crash.
+//
+// With --fork, the test cases run in child processes instead (see fork-session.hpp).
+
+#include "catch.hpp"
+
+#include "fork-session.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace extensions {
+
+    namespace detail {
+        using Event = std::function<void(Catch::IStreamingReporter &)>;
+
+        // Records the events of one test case run on a worker thread, for replaying on the main thread
+        class RecordingReporter : public Catch::IStreamingReporter {
+        public:
+            explicit RecordingReporter(Catch::ReporterPreferences preferences) : preferences(preferences) {
+                // Redirecting std::cout swaps a global stream buffer, which other threads are writing to
+                this->preferences.shouldRedirectStdOut = false;
+            }
+
+            std::vector<Event> takeEvents() {
+                auto taken = std::move(events);
+                events.clear();
+                return taken;
+            }
+
+            Catch::ReporterPreferences getPreferences() const override {
+                return preferences;
+            }
+
+            void noMatchingTestCases(std::string const &) override {}
+
+            void testRunStarting(Catch::TestRunInfo const &) override {}
+
+            void testGroupStarting(Catch::GroupInfo const &) override {}
+
+            void testCaseStarting(Catch::TestCaseInfo const &testInfo) override {
+                events.emplace_back([testInfo](Catch::IStreamingReporter &r) { r.testCaseStarting(testInfo); });
+            }
+
+            void sectionStarting(Catch::SectionInfo const &sectionInfo) override {
+                events.emplace_back([sectionInfo](Catch::IStreamingReporter &r) { r.sectionStarting(sectionInfo); });
+            }
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+            void benchmarkPreparing(std::string const &name) override {
+                events.emplace_back([name](Catch::IStreamingReporter &r) { r.benchmarkPreparing(name); });
+            }
+
+            void benchmarkStarting(Catch::BenchmarkInfo const &info) override {
+                events.emplace_back([info](Catch::IStreamingReporter &r) { r.benchmarkStarting(info); });
+            }
+
+            void benchmarkEnded(Catch::BenchmarkStats<> const &stats) override {
+                events.emplace_back([stats](Catch::IStreamingReporter &r) { r.benchmarkEnded(stats); });
+            }
+
+            void benchmarkFailed(std::string const &error) override {
+                events.emplace_back([error](Catch::IStreamingReporter &r) { r.benchmarkFailed(error); });
+            }
+#endif
+
+            void assertionStarting(Catch::AssertionInfo const &assertionInfo) override {
+                events.emplace_back([assertionInfo](Catch::IStreamingReporter &r) { r.assertionStarting(assertionInfo); });
+            }
+
+            bool assertionEnded(Catch::AssertionStats const &assertionStats) override {
+                events.emplace_back([stats = detach(assertionStats)](Catch::IStreamingReporter &r) { r.assertionEnded(stats); });
+                return true;
+            }
+
+            void sectionEnded(Catch::SectionStats const &sectionStats) override {
+                events.emplace_back([sectionStats](Catch::IStreamingReporter &r) { r.sectionEnded(sectionStats); });
+            }
+
+            void testCaseEnded(Catch::TestCaseStats const &testCaseStats) override {
+                events.emplace_back([testCaseStats](Catch::IStreamingReporter &r) { r.testCaseEnded(testCaseStats); });
+            }
+
+            void testGroupEnded(Catch::TestGroupStats const &) override {}
+
+            void testRunEnded(Catch::TestRunStats const &) override {}
+
+            void skipTest(Catch::TestCaseInfo const &) override {}
+
+        private:
+            Catch::ReporterPreferences preferences;
+            std::vector<Event> events;
+
+            // The result's expression is only expanded on demand, from an object on the test's stack,
+            // so expand it now while that still exists
+            static Catch::AssertionStats detach(Catch::AssertionStats const &stats) {
+                auto const &result = stats.assertionResult;
+                Catch::AssertionResultData data(result.m_resultData.resultType, Catch::LazyExpression(false));
+                data.message = result.m_resultData.message;
+                data.reconstructedExpression = result.m_resultData.reconstructExpression();
+
+                Catch::AssertionStats detached(Catch::AssertionResult(result.m_info, data), stats.infoMessages, stats.totals);
+                // The constructor appends the result's message to the info messages (again)
+                detached.infoMessages = stats.infoMessages;
+                return detached;
+            }
+        };
+
+        // Every worker takes work from the front of its own queue, and steals from the back of the
+        // others' once that's empty
+        class WorkStealingQueues {
+        public:
+            WorkStealingQueues(std::size_t workers, std::size_t items) : queues(workers) {
+                // Round robin, so the first test cases in declaration order (which the main thread
+                // waits for first) are started first
+                for (std::size_t item = 0; item < items; ++item) {
+                    queues[item % workers].items.push_back(item);
+                }
+            }
+
+            bool next(std::size_t worker, std::size_t &item) {
+                for (std::size_t i = 0; i < queues.size(); ++i) {
+                    auto &queue = queues[(worker + i) % queues.size()];
+                    std::lock_guard<std::mutex> lock(queue.mutex);
+                    if (queue.items.empty()) {
+                        continue;
+                    }
+                    if (i == 0) {
+                        item = queue.items.front();
+                        queue.items.pop_front();
+                    } else {
+                        item = queue.items.back();
+                        queue.items.pop_back();
+                    }
+                    return true;
+                }
+                return false;
+            }
+
+        private:
+            struct Queue {
+                std::mutex mutex;
+                std::deque<std::size_t> items;
+            };
+
+            std::vector<Queue> queues;
+        };
+
+        struct ParallelResult {
+            std::vector<Event> events;
+            Catch::Totals totals;
+            bool skipped = false;
+        };
+
+        inline bool isParallel(Catch::TestCase const &testCase) {
+            auto const &tags = testCase.getTestCaseInfo().lcaseTags;
+            return std::find(tags.begin(), tags.end(), "parallel") != tags.end();
+        }
+
+        using Order = std::function<void(std::vector<Catch::TestCase const *> &)>;
+
+        // Catch's TestGroup (see Session::runInternal), running [parallel] test cases on worker threads
+        // (if threads > 0), in the order `order` sorts them into (if any), which can also leave some out.
+        // Runs the other test cases in child processes, forkBatch at a time, if forkBatch > 0.
+        class ParallelTestGroup {
+        public:
+            ParallelTestGroup(std::shared_ptr<Catch::Config> const &config, unsigned threads, Order const &order,
+                              std::size_t forkBatch = 0)
+                    : m_config{config}, m_context{config, Catch::makeReporter(config)}, m_threads{threads},
+                      m_forkBatch{forkBatch} {
+                auto const &allTestCases = Catch::getAllTestCasesSorted(*m_config);
+                m_matches = m_config->testSpec().matchesByFilter(allTestCases, *m_config);
+                auto const &invalidArgs = m_config->testSpec().getInvalidArgs();
+
+                if (m_matches.empty() && invalidArgs.empty()) {
+                    for (auto const &test : allTestCases)
+                        if (!test.isHidden())
+                            m_tests.emplace(&test);
+                } else {
+                    for (auto const &match : m_matches)
+                        m_tests.insert(match.tests.begin(), match.tests.end());
+                }
+
+                // The set is ordered by address, which is the configured order: they're all in one vector
+                m_ordered.assign(m_tests.begin(), m_tests.end());
+                if (order) {
+                    order(m_ordered);
+                }
+            }
+
+            Catch::Totals execute() {
+                auto const &invalidArgs = m_config->testSpec().getInvalidArgs();
+                Catch::Totals totals;
+                m_context.testGroupStarting(m_config->name(), 1, 1);
+
+                std::vector<Catch::TestCase const *> parallel;
+                if (m_threads > 0) {
+                    std::copy_if(m_ordered.begin(), m_ordered.end(), std::back_inserter(parallel),
+                                 [](Catch::TestCase const *testCase) { return isParallel(*testCase); });
+                }
+                std::vector<std::promise<ParallelResult>> promises(parallel.size());
+                WorkStealingQueues queues(m_threads, parallel.size());
+                std::atomic<bool> stop{false};
+
+                std::vector<std::thread> workers;
+                // Stops and joins the workers if a test case's exception (rethrown by get()) ends this early
+                struct Joiner {
+                    std::atomic<bool> &stop;
+                    std::vector<std::thread> &workers;
+
+                    ~Joiner() {
+                        stop = true;
+                        for (auto &worker : workers) {
+                            if (worker.joinable()) {
+                                worker.join();
+                            }
+                        }
+                    }
+                } joiner{stop, workers};
+                for (std::size_t worker = 0; worker < std::min<std::size_t>(m_threads, parallel.size()); ++worker) {
+                    workers.emplace_back([&, worker] { runWorker(worker, parallel, promises, queues, stop); });
+                }
+
+                std::unique_ptr<ForkedRunner> forked;
+                if (m_forkBatch > 0) {
+                    forked.reset(new ForkedRunner(m_config, m_context.reporter().getPreferences(), m_forkBatch));
+                }
+
+                std::size_t nextParallel = 0;
+                for (auto const &testCase : m_ordered) {
+                    if (m_threads == 0 || !isParallel(*testCase)) {
+                        if (!m_context.aborting())
+                            totals += forked ? forked->run(m_context, *testCase) : m_context.runTest(*testCase);
+                        else
+                            m_context.reporter().skipTest(*testCase);
+                        continue;
+                    }
+
+                    auto result = promises[nextParallel++].get_future().get();
+                    if (m_context.aborting() || result.skipped) {
+                        stop = true;
+                        m_context.reporter().skipTest(*testCase);
+                        continue;
+                    }
+                    for (auto const &event : result.events) {
+                        event(m_context.reporter());
+                    }
+                    m_context.addTotals(result.totals);
+                    totals += result.totals;
+                }
+                stop = true;
+                for (auto &worker : workers) {
+                    worker.join();
+                }
+
+                for (auto const &match : m_matches) {
+                    if (match.tests.empty()) {
+                        m_context.reporter().noMatchingTestCases(match.name);
+                        totals.error = -1;
+                    }
+                }
+
+                if (!invalidArgs.empty()) {
+                    for (auto const &invalidArg: invalidArgs)
+                        m_context.reporter().reportInvalidArguments(invalidArg);
+                }
+
+                m_context.testGroupEnded(m_config->name(), totals, 1, 1);
+                return totals;
+            }
+
+        private:
+            using Tests = std::set<Catch::TestCase const *>;
+
+            std::shared_ptr<Catch::Config> m_config;
+            Catch::RunContext m_context;
+            unsigned m_threads;
+            std::size_t m_forkBatch;
+            Tests m_tests;
+            std::vector<Catch::TestCase const *> m_ordered;
+            Catch::TestSpec::Matches m_matches;
+
+            void runWorker(std::size_t worker,
+                           std::vector<Catch::TestCase const *> const &parallel,
+                           std::vector<std::promise<ParallelResult>> &promises,
+                           WorkStealingQueues &queues,
+                           std::atomic<bool> const &stop) {
+                {
+                    auto recorder = new RecordingReporter(m_context.reporter().getPreferences());
+                    Catch::RunContext context(m_config, Catch::IStreamingReporterPtr(recorder));
+                    context.setHandleFatalConditions(false);
+
+                    std::size_t index;
+                    while (queues.next(worker, index)) {
+                        if (stop) {
+                            ParallelResult skipped;
+                            skipped.skipped = true;
+                            promises[index].set_value(std::move(skipped));
+                            continue;
+                        }
+                        CATCH_TRY {
+                            ParallelResult result;
+                            result.totals = context.runTest(*parallel[index]);
+                            result.events = recorder->takeEvents();
+                            promises[index].set_value(std::move(result));
+                        } CATCH_CATCH_ALL {
+                            promises[index].set_exception(std::current_exception());
+                        }
+                    }
+                }
+                // This thread's Catch context, created by its RunContext
+                Catch::cleanUpContext();
+            }
+        };
+    }
+
+    // Session::run(), with the test cases tagged [parallel] spread over `threads` threads (if any),
+    // in the order `order` sorts them into (if any), which can also leave some out, and the others
+    // in child processes running forkBatch test cases each (if forkBatch > 0)
+    inline int runParallel(Catch::Session &session, unsigned threads, detail::Order const &order = {},
+                           std::size_t forkBatch = 0) {
+        auto const &configData = session.configData();
+        if (configData.showHelp || configData.libIdentify) {
+            return 0;
+        }
+
+        CATCH_TRY {
+            auto config = std::make_shared<Catch::Config>(configData);
+
+            Catch::seedRng(*config);
+
+            if (configData.filenamesAsTags)
+                Catch::applyFilenamesAsTags(*config);
+
+            // Handle list request
+            if (Catch::Option<std::size_t> listed = Catch::list(config))
+                return static_cast<int>(*listed);
+
+            detail::ParallelTestGroup tests{config, threads, order, forkBatch};
+            auto const totals = tests.execute();
+
+            if (config->warnAboutNoTests() && totals.error == -1)
+                return 2;
+
+            return (std::min)(Catch::MaxExitCode, (std::max)(totals.error, static_cast<int>(totals.assertions.failed)));
+        }
+#if !defined(CATCH_CONFIG_DISABLE_EXCEPTIONS)
+        catch (std::exception &ex) {
+            Catch::cerr() << ex.what() << std::endl;
+            return Catch::MaxExitCode;
+        }
+#endif
+    }
+}
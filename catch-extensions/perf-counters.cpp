@@ -0,0 +1,325 @@
+// Hardware performance counters (perf-counters.hpp), and the reporters that report them for every
+// test case and benchmark when the tests are run with --perf: "perf-console" and "perf-xml", which
+// main.cpp uses in place of "console" and "xml".
+//
+// A benchmark's counters cover only the taking of its samples (see Catch::Benchmark::Detail::samplingHook),
+// and are reported per iteration, and per element for benchmarks named "... (n = <elements>)".
+
+#define CATCH_CONFIG_EXTERNAL_INTERFACES
+
+#include "catch.hpp"
+
+#include "perf-counters.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace extensions {
+
+#if defined(__linux__)
+    PerfCounters::PerfCounters() {
+        const std::uint64_t configs[PerfEventCount] = {
+                PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+        };
+        for (int event = 0; event < PerfEventCount; ++event) {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[event];
+            attr.disabled = 1;
+            // User space only, which is all that perf_event_paranoid = 2 (the usual default) allows
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fds[event] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fds[event] < 0 && openError.empty()) {
+                openError = std::strerror(errno);
+            }
+        }
+    }
+
+    PerfCounters::~PerfCounters() {
+        for (int fd : fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    void PerfCounters::start() {
+        for (int fd : fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+    }
+
+    PerfCounts PerfCounters::read() const {
+        PerfCounts counts;
+        for (int event = 0; event < PerfEventCount; ++event) {
+            std::uint64_t value = 0;
+            if (fds[event] >= 0 && ::read(fds[event], &value, sizeof(value)) == sizeof(value)) {
+                counts.values[event] = value;
+                counts.valid[event] = true;
+            }
+        }
+        return counts;
+    }
+
+    PerfCounts PerfCounters::stop() {
+        for (int fd : fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        return read();
+    }
+#else
+    PerfCounters::PerfCounters() : openError("only available on Linux") {
+        fds.fill(-1);
+    }
+
+    PerfCounters::~PerfCounters() = default;
+
+    void PerfCounters::start() {}
+
+    PerfCounts PerfCounters::read() const {
+        return {};
+    }
+
+    PerfCounts PerfCounters::stop() {
+        return {};
+    }
+#endif
+
+    bool PerfCounters::available() const {
+        for (int fd : fds) {
+            if (fd >= 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::uint64_t elementsIn(std::string const &benchmarkName) {
+        auto n = benchmarkName.rfind("(n = ");
+        return n == std::string::npos ? 0 : std::strtoull(benchmarkName.c_str() + n + 5, nullptr, 10);
+    }
+}
+
+namespace {
+    using extensions::PerfCounts;
+
+    const char *const eventNames[extensions::PerfEventCount] = {"cycles", "instructions", "cacheMisses", "branchMisses"};
+
+    // Counts every test case, and every benchmark's sampling, for the reporters below
+    class PerfRecorder {
+    public:
+        PerfRecorder() {
+            if (!counters.available()) {
+                Catch::cerr() << "--perf: no hardware performance counters (" << counters.error() << ")" << std::endl;
+            }
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+            active() = this;
+            Catch::Benchmark::Detail::samplingHook() = &onSampling;
+#endif
+        }
+
+        ~PerfRecorder() {
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+            Catch::Benchmark::Detail::samplingHook() = nullptr;
+            active() = nullptr;
+#endif
+        }
+
+        bool available() const {
+            return counters.available();
+        }
+
+        void testCaseStarting() {
+            counters.start();
+        }
+
+        PerfCounts testCaseEnded() {
+            return counters.stop();
+        }
+
+        // The last benchmark's
+        PerfCounts const &sampling() const {
+            return samplingCounts;
+        }
+
+    private:
+        extensions::PerfCounters counters;
+        PerfCounts samplingStart;
+        PerfCounts samplingCounts;
+
+        static PerfRecorder *&active() {
+            static PerfRecorder *recorder = nullptr;
+            return recorder;
+        }
+
+        // The samples are taken inside the test case, so its counters are still running
+        static void onSampling(bool starting) {
+            auto recorder = active();
+            if (starting) {
+                recorder->samplingStart = recorder->counters.read();
+            } else {
+                recorder->samplingCounts = recorder->counters.read() - recorder->samplingStart;
+            }
+        }
+    };
+
+    std::string describe(PerfCounts const &counts, double per, const char *unit) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(2);
+        const char *labels[extensions::PerfEventCount] = {"cycles", "instructions", "cache misses", "branch misses"};
+        bool first = true;
+        if (counts.ipc() > 0) {
+            out << counts.ipc() << " IPC";
+            first = false;
+        }
+        // Whole counts are whole numbers
+        out << std::setprecision(per == 1 ? 0 : 2);
+        for (int event = 0; event < extensions::PerfEventCount; ++event) {
+            if (counts.valid[event]) {
+                out << (first ? "" : ", ") << counts.values[event] / per << " " << labels[event] << unit;
+                first = false;
+            }
+        }
+        return out.str();
+    }
+
+    struct PerfConsoleReporter : Catch::ConsoleReporter {
+        using ConsoleReporter::ConsoleReporter;
+
+        static std::string getDescription() {
+            return "The console reporter, plus hardware performance counters for every test case and benchmark";
+        }
+
+        void testCaseStarting(Catch::TestCaseInfo const &testInfo) override {
+            ConsoleReporter::testCaseStarting(testInfo);
+            recorder.testCaseStarting();
+        }
+
+        void testCaseEnded(Catch::TestCaseStats const &testCaseStats) override {
+            auto counts = recorder.testCaseEnded();
+            ConsoleReporter::testCaseEnded(testCaseStats);
+            if (recorder.available()) {
+                // Like --durations
+                stream << describe(counts, 1, "") << ": " << testCaseStats.testInfo.name << std::endl;
+            }
+        }
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+        void benchmarkStarting(Catch::BenchmarkInfo const &info) override {
+            ConsoleReporter::benchmarkStarting(info);
+            iterations = static_cast<double>(info.samples) * info.iterations;
+            elements = static_cast<double>(extensions::elementsIn(info.name));
+        }
+
+        void benchmarkEnded(Catch::BenchmarkStats<> const &stats) override {
+            ConsoleReporter::benchmarkEnded(stats);
+            if (recorder.available()) {
+                auto &counts = recorder.sampling();
+                auto perElement = elements > 0 ? describe(counts, iterations * elements, "/element")
+                                                : describe(counts, iterations, "/iteration");
+                benchmarks.push_back(stats.info.name + ": " + perElement);
+            }
+        }
+
+        // The benchmarks' table ends with the section, so they're listed below it
+        void sectionEnded(Catch::SectionStats const &sectionStats) override {
+            ConsoleReporter::sectionEnded(sectionStats);
+            for (auto &benchmark : benchmarks) {
+                stream << benchmark << "\n";
+            }
+            if (!benchmarks.empty()) {
+                stream << std::endl;
+            }
+            benchmarks.clear();
+        }
+#endif
+
+    private:
+        PerfRecorder recorder;
+        double iterations = 1;
+        double elements = 0;
+        std::vector<std::string> benchmarks;
+    };
+
+    struct PerfXmlReporter : Catch::XmlReporter {
+        using XmlReporter::XmlReporter;
+
+        static std::string getDescription() {
+            return "The xml reporter, plus a <PerfCounters> element for every test case and benchmark";
+        }
+
+        void testCaseStarting(Catch::TestCaseInfo const &testInfo) override {
+            XmlReporter::testCaseStarting(testInfo);
+            recorder.testCaseStarting();
+        }
+
+        void testCaseEnded(Catch::TestCaseStats const &testCaseStats) override {
+            writeCounts(recorder.testCaseEnded(), 0, 0);
+            XmlReporter::testCaseEnded(testCaseStats);
+        }
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+        void benchmarkStarting(Catch::BenchmarkInfo const &info) override {
+            XmlReporter::benchmarkStarting(info);
+            iterations = static_cast<double>(info.samples) * info.iterations;
+            elements = static_cast<double>(extensions::elementsIn(info.name));
+        }
+
+        void benchmarkEnded(Catch::BenchmarkStats<> const &stats) override {
+            writeCounts(recorder.sampling(), iterations, elements);
+            XmlReporter::benchmarkEnded(stats);
+        }
+#endif
+
+    private:
+        PerfRecorder recorder;
+        double iterations = 1;
+        double elements = 0;
+
+        // Totals, plus per iteration and per element values if there are any
+        void writeCounts(PerfCounts const &counts, double iterations, double elements) {
+            if (!recorder.available()) {
+                return;
+            }
+            auto element = m_xml.scopedElement("PerfCounters");
+            if (counts.ipc() > 0) {
+                element.writeAttribute("ipc", counts.ipc());
+            }
+            for (int event = 0; event < extensions::PerfEventCount; ++event) {
+                if (!counts.valid[event]) {
+                    continue;
+                }
+                element.writeAttribute(eventNames[event], counts.values[event]);
+                if (iterations > 0) {
+                    element.writeAttribute(std::string(eventNames[event]) + "PerIteration", counts.values[event] / iterations);
+                }
+                if (iterations > 0 && elements > 0) {
+                    element.writeAttribute(std::string(eventNames[event]) + "PerElement",
+                                           counts.values[event] / (iterations * elements));
+                }
+            }
+        }
+    };
+}
+
+CATCH_REGISTER_REPORTER("perf-console", PerfConsoleReporter)
+CATCH_REGISTER_REPORTER("perf-xml", PerfXmlReporter)
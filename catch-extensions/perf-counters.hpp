@@ -0,0 +1,71 @@
+#pragma once
+
+// Hardware performance counters for the calling thread, through Linux's perf_event_open: cycles,
+// instructions, cache misses and branch misses. Counters the kernel (or a VM) doesn't provide are
+// left out; elsewhere than Linux there are none.
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace extensions {
+
+    enum PerfEvent { Cycles, Instructions, CacheMisses, BranchMisses, PerfEventCount };
+
+    struct PerfCounts {
+        std::array<std::uint64_t, PerfEventCount> values{};
+        // False for the counters that couldn't be opened
+        std::array<bool, PerfEventCount> valid{};
+
+        bool has(PerfEvent event) const {
+            return valid[event];
+        }
+
+        PerfCounts operator-(PerfCounts const &before) const {
+            PerfCounts difference = *this;
+            for (int event = 0; event < PerfEventCount; ++event) {
+                difference.values[event] -= before.values[event];
+            }
+            return difference;
+        }
+
+        // Instructions per cycle, 0 without both counters
+        double ipc() const {
+            return has(Cycles) && has(Instructions) && values[Cycles] > 0
+                   ? static_cast<double>(values[Instructions]) / values[Cycles] : 0;
+        }
+    };
+
+    class PerfCounters {
+    public:
+        PerfCounters();
+
+        ~PerfCounters();
+
+        PerfCounters(PerfCounters const &) = delete;
+
+        PerfCounters &operator=(PerfCounters const &) = delete;
+
+        bool available() const;
+
+        // Why some counter couldn't be opened, if one couldn't
+        std::string const &error() const {
+            return openError;
+        }
+
+        // Starts counting from zero
+        void start();
+
+        // What was counted since start(), while still counting
+        PerfCounts read() const;
+
+        PerfCounts stop();
+
+    private:
+        std::array<int, PerfEventCount> fds;
+        std::string openError;
+    };
+
+    // The n of a benchmark named like "std::set find (n = 1000)" (see benchmarks.cpp), 0 if there's none
+    std::uint64_t elementsIn(std::string const &benchmarkName);
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+// Checks every element of a range in a single assertion:
+//
+//   REQUIRE_ALL_OF(squares, [](int i) { return i > 0; });
+//   CHECK_RANGE(evens, std::vector<int>{2, 4, 6, 8});
+//
+// The elements are checked in a plain loop, with none of an assertion's bookkeeping per element,
+// so ranges of millions of elements are cheap to check. A failure shows how many elements didn't
+// match, and the first few of them with their indices, instead of stringifying the whole range.
+
+#include "catch.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace extensions {
+
+    // How many of the mismatching elements a failure shows
+    constexpr std::size_t reportedMismatches = 5;
+
+    struct RangeCheck {
+        std::size_t checked = 0;
+        std::size_t mismatches = 0;
+        // "[index] element", for the first reportedMismatches of them
+        std::vector<std::string> firstMismatches;
+        // Set by CHECK_RANGE when the ranges' sizes differ
+        std::string sizes;
+
+        explicit operator bool() const {
+            return mismatches == 0 && sizes.empty();
+        }
+
+        // Only the first mismatches are described, so describe is only called for them
+        template<typename Describe>
+        void mismatch(std::size_t index, Describe &&describe) {
+            if (++mismatches <= reportedMismatches) {
+                firstMismatches.push_back("[" + std::to_string(index) + "] " + describe());
+            }
+        }
+    };
+
+    template<typename Range, typename Predicate>
+    RangeCheck allOf(Range const &range, Predicate &&predicate) {
+        RangeCheck check;
+        std::size_t index = 0;
+        for (auto const &element : range) {
+            if (!predicate(element)) {
+                check.mismatch(index, [&] { return Catch::Detail::stringify(element); });
+            }
+            ++index;
+        }
+        check.checked = index;
+        return check;
+    }
+
+    // Compares the ranges element by element, as far as the shorter one goes
+    template<typename Actual, typename Expected>
+    RangeCheck equalRanges(Actual const &actual, Expected const &expected) {
+        RangeCheck check;
+        auto a = std::begin(actual), aEnd = std::end(actual);
+        auto e = std::begin(expected), eEnd = std::end(expected);
+        std::size_t index = 0;
+        for (; a != aEnd && e != eEnd; ++a, ++e, ++index) {
+            if (!(*a == *e)) {
+                check.mismatch(index, [&] { return Catch::Detail::stringify(*a) + " != " + Catch::Detail::stringify(*e); });
+            }
+        }
+        check.checked = index;
+        if (a != aEnd || e != eEnd) {
+            auto actualSize = index + static_cast<std::size_t>(std::distance(a, aEnd));
+            auto expectedSize = index + static_cast<std::size_t>(std::distance(e, eEnd));
+            check.sizes = "sizes differ: " + std::to_string(actualSize) + " != " + std::to_string(expectedSize);
+        }
+        return check;
+    }
+}
+
+namespace Catch {
+    template<>
+    struct StringMaker<extensions::RangeCheck> {
+        static std::string convert(extensions::RangeCheck const &check) {
+            std::string description = check.sizes.empty() ? "" : check.sizes + ", ";
+            if (check.mismatches == 0) {
+                return description + std::to_string(check.checked) + " elements match";
+            }
+            description += std::to_string(check.mismatches) + " of " + std::to_string(check.checked)
+                           + " elements don't match: ";
+            for (std::size_t i = 0; i < check.firstMismatches.size(); ++i) {
+                description += (i == 0 ? "" : ", ") + check.firstMismatches[i];
+            }
+            return description + (check.mismatches > check.firstMismatches.size() ? ", ..." : "");
+        }
+    };
+}
+
+// INTERNAL_CATCH_TEST, but showing the macro's arguments rather than the check that implements it
+#define INTERNAL_CHECK_RANGE(macroName, resultDisposition, captured, check) \
+    do { \
+        Catch::AssertionHandler catchAssertionHandler(macroName##_catch_sr, CATCH_INTERNAL_LINEINFO, captured, resultDisposition); \
+        INTERNAL_CATCH_TRY { \
+            catchAssertionHandler.handleExpr(Catch::Decomposer() <= check); \
+        } INTERNAL_CATCH_CATCH(catchAssertionHandler) \
+        INTERNAL_CATCH_REACT(catchAssertionHandler) \
+    } while (false)
+
+#define REQUIRE_ALL_OF(range, ...) INTERNAL_CHECK_RANGE("REQUIRE_ALL_OF", Catch::ResultDisposition::Normal, \
+    #range ", " #__VA_ARGS__, ::extensions::allOf(range, __VA_ARGS__))
+#define CHECK_ALL_OF(range, ...) INTERNAL_CHECK_RANGE("CHECK_ALL_OF", Catch::ResultDisposition::ContinueOnFailure, \
+    #range ", " #__VA_ARGS__, ::extensions::allOf(range, __VA_ARGS__))
+#define REQUIRE_RANGE(actual, ...) INTERNAL_CHECK_RANGE("REQUIRE_RANGE", Catch::ResultDisposition::Normal, \
+    #actual ", " #__VA_ARGS__, ::extensions::equalRanges(actual, __VA_ARGS__))
+#define CHECK_RANGE(actual, ...) INTERNAL_CHECK_RANGE("CHECK_RANGE", Catch::ResultDisposition::ContinueOnFailure, \
+    #actual ", " #__VA_ARGS__, ::extensions::equalRanges(actual, __VA_ARGS__))
@@ -0,0 +1,94 @@
+// A listener that writes one JSON object per line for every test case that ran:
+//   {"name": "Factorial works", "seconds": 0.000012, "passed": true}
+// when the tests are run with --record <file>. The tools in tools/ turn these into a test history;
+// with --history <file> it updates that history itself at the end of the run, and with --cache <file>
+// the test result cache (tools/test-cache.hpp).
+
+#define CATCH_CONFIG_EXTERNAL_INTERFACES
+
+#include "catch.hpp"
+
+#include "options.hpp"
+#include "tools/json.hpp"
+#include "tools/test-cache.hpp"
+#include "tools/test-history.hpp"
+
+#include <fstream>
+
+namespace {
+    struct TestRecordListener : Catch::TestEventListenerBase {
+        using TestEventListenerBase::TestEventListenerBase;
+
+        void testRunStarting(Catch::TestRunInfo const &testRunInfo) override {
+            TestEventListenerBase::testRunStarting(testRunInfo);
+            if (!extensions::options().recordFile.empty()) {
+                out.open(extensions::options().recordFile);
+                if (!out) {
+                    CATCH_ERROR("Unable to open record file: '" << extensions::options().recordFile << "'");
+                }
+                out.precision(9);
+            }
+        }
+
+        void testCaseStarting(Catch::TestCaseInfo const &testInfo) override {
+            TestEventListenerBase::testCaseStarting(testInfo);
+            seconds = 0;
+        }
+
+        void sectionStarting(Catch::SectionInfo const &sectionInfo) override {
+            TestEventListenerBase::sectionStarting(sectionInfo);
+            ++depth;
+        }
+
+        // The test case's own time is the sum of its runs of the root section (once per path through
+        // its sections and generators). Timing it here rather than with a timer of our own keeps it
+        // right when --threads replays a test case that ran on another thread.
+        void sectionEnded(Catch::SectionStats const &sectionStats) override {
+            if (--depth == 0) {
+                seconds += sectionStats.durationInSeconds;
+            }
+            TestEventListenerBase::sectionEnded(sectionStats);
+        }
+
+        void testCaseEnded(Catch::TestCaseStats const &testCaseStats) override {
+            history::Record record{testCaseStats.testInfo.name, seconds, testCaseStats.totals.assertions.allOk()};
+            if (out.is_open()) {
+                out << "{\"name\": \"" << json::escape(record.name) << "\", "
+                    << "\"seconds\": " << record.seconds << ", "
+                    << "\"passed\": " << (record.passed ? "true" : "false") << "}\n";
+                out.flush();
+            }
+            records.push_back(record);
+            files[record.name] = testCaseStats.testInfo.lineInfo.file;
+            TestEventListenerBase::testCaseEnded(testCaseStats);
+        }
+
+        void testRunEnded(Catch::TestRunStats const &testRunStats) override {
+            auto const &historyFile = extensions::options().historyFile;
+            if (!historyFile.empty()) {
+                auto testHistory = history::load(historyFile);
+                history::update(testHistory, records);
+                history::save(testHistory, historyFile);
+            }
+            auto const &cacheFile = extensions::options().cacheFile;
+            if (!cacheFile.empty()) {
+                auto testCache = cache::load(cacheFile);
+                cache::SourceHasher hasher;
+                for (auto &record : records) {
+                    testCache[record.name] = {hasher.hash(files[record.name]), record.passed};
+                }
+                cache::save(testCache, cacheFile);
+            }
+            TestEventListenerBase::testRunEnded(testRunStats);
+        }
+
+    private:
+        std::ofstream out;
+        int depth = 0;
+        double seconds = 0;
+        std::vector<history::Record> records;
+        std::map<std::string, std::string> files;
+    };
+}
+
+CATCH_REGISTER_LISTENER(TestRecordListener)
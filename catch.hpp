@@ -552,12 +552,15 @@ namespace Catch {
     };
 
     class TestCase;
+    class TestCaseIndex;
     struct IConfig;
 
     struct ITestCaseRegistry {
         virtual ~ITestCaseRegistry();
         virtual std::vector<TestCase> const& getAllTests() const = 0;
         virtual std::vector<TestCase> const& getAllTestsSorted( IConfig const& config ) const = 0;
+        // Built on first use, and kept while testCases, one of the two above, doesn't change
+        virtual TestCaseIndex const& getIndex( std::vector<TestCase> const& testCases ) const = 0;
     };
 
     bool isThrowSafe( TestCase const& testCase, IConfig const& config );
@@ -965,8 +968,52 @@ struct AutoReg : NonCopyable {
     ~AutoReg();
 };
 
+// With CATCH_CONFIG_LAZY_REGISTRATION, TEST_CASE and TEST_CASE_METHOD don't register their test
+// case while the program starts. Each one puts a pointer to a constant TableEntry in the
+// catch_test_table section instead, which the linker gathers from all the object files, and the
+// TestRegistry turns the entries into TestCases the first time it's asked for them. So there's no
+// code to run per test case before main(). Needs an ELF linker (which defines __start_/__stop_
+// symbols for the section): elsewhere the test cases are registered as usual.
+#if defined(CATCH_CONFIG_LAZY_REGISTRATION) && defined(__ELF__) && ( defined(__GNUC__) || defined(__clang__) ) && !defined(CATCH_CONFIG_DISABLE)
+#  define CATCH_INTERNAL_CONFIG_LAZY_REGISTRATION
+#endif
+
+namespace Detail {
+
+    struct TableNameAndTags {
+        constexpr TableNameAndTags( char const* name_ = "", char const* tags_ = "" ) noexcept : name( name_ ), tags( tags_ ) {}
+        char const* name;
+        char const* tags;
+    };
+
+    struct TableEntry {
+        ITestInvoker* (*makeInvoker)();
+        char const* className;
+        TableNameAndTags nameAndTags;
+        char const* file;
+        std::size_t line;
+    };
+
+    template<void(*testAsFunction)()>
+    ITestInvoker* makeTableInvoker() {
+        return makeTestInvoker( testAsFunction );
+    }
+
+    template<typename C>
+    ITestInvoker* makeTableMethodInvoker() {
+        return makeTestInvoker( &C::test );
+    }
+
+} // end namespace Detail
+
 } // end namespace Catch
 
+#if defined(CATCH_INTERNAL_CONFIG_LAZY_REGISTRATION)
+    #define INTERNAL_CATCH_TABLE_ENTRY( TestName, makeInvoker, className, ... ) \
+        static constexpr Catch::Detail::TableEntry TestName##_tableEntry{ makeInvoker, className, Catch::Detail::TableNameAndTags{ __VA_ARGS__ }, __FILE__, static_cast<std::size_t>( __LINE__ ) }; \
+        __attribute__((used, section("catch_test_table"))) static Catch::Detail::TableEntry const* const TestName##_tableEntryPointer = &TestName##_tableEntry;
+#endif
+
 #if defined(CATCH_CONFIG_DISABLE)
     #define INTERNAL_CATCH_TESTCASE_NO_REGISTRATION( TestName, ... ) \
         static void TestName()
@@ -1021,6 +1068,15 @@ struct AutoReg : NonCopyable {
 #endif
 
     ///////////////////////////////////////////////////////////////////////////////
+#if defined(CATCH_INTERNAL_CONFIG_LAZY_REGISTRATION)
+    #define INTERNAL_CATCH_TESTCASE2( TestName, ... ) \
+        static void TestName(); \
+        CATCH_INTERNAL_START_WARNINGS_SUPPRESSION \
+        CATCH_INTERNAL_SUPPRESS_GLOBALS_WARNINGS \
+        namespace{ INTERNAL_CATCH_TABLE_ENTRY( TestName, &Catch::Detail::makeTableInvoker<&TestName>, "", __VA_ARGS__ ) } /* NOLINT */ \
+        CATCH_INTERNAL_STOP_WARNINGS_SUPPRESSION \
+        static void TestName()
+#else
     #define INTERNAL_CATCH_TESTCASE2( TestName, ... ) \
         static void TestName(); \
         CATCH_INTERNAL_START_WARNINGS_SUPPRESSION \
@@ -1028,6 +1084,7 @@ struct AutoReg : NonCopyable {
         namespace{ Catch::AutoReg INTERNAL_CATCH_UNIQUE_NAME( autoRegistrar )( Catch::makeTestInvoker( &TestName ), CATCH_INTERNAL_LINEINFO, Catch::StringRef(), Catch::NameAndTags{ __VA_ARGS__ } ); } /* NOLINT */ \
         CATCH_INTERNAL_STOP_WARNINGS_SUPPRESSION \
         static void TestName()
+#endif
     #define INTERNAL_CATCH_TESTCASE( ... ) \
         INTERNAL_CATCH_TESTCASE2( INTERNAL_CATCH_UNIQUE_NAME( ____C_A_T_C_H____T_E_S_T____ ), __VA_ARGS__ )
 
@@ -1039,6 +1096,19 @@ struct AutoReg : NonCopyable {
         CATCH_INTERNAL_STOP_WARNINGS_SUPPRESSION
 
     ///////////////////////////////////////////////////////////////////////////////
+#if defined(CATCH_INTERNAL_CONFIG_LAZY_REGISTRATION)
+    #define INTERNAL_CATCH_TEST_CASE_METHOD2( TestName, ClassName, ... )\
+        CATCH_INTERNAL_START_WARNINGS_SUPPRESSION \
+        CATCH_INTERNAL_SUPPRESS_GLOBALS_WARNINGS \
+        namespace{ \
+            struct TestName : INTERNAL_CATCH_REMOVE_PARENS(ClassName) { \
+                void test(); \
+            }; \
+            INTERNAL_CATCH_TABLE_ENTRY( TestName, &Catch::Detail::makeTableMethodInvoker<TestName>, #ClassName, __VA_ARGS__ ) /* NOLINT */ \
+        } \
+        CATCH_INTERNAL_STOP_WARNINGS_SUPPRESSION \
+        void TestName::test()
+#else
     #define INTERNAL_CATCH_TEST_CASE_METHOD2( TestName, ClassName, ... )\
         CATCH_INTERNAL_START_WARNINGS_SUPPRESSION \
         CATCH_INTERNAL_SUPPRESS_GLOBALS_WARNINGS \
@@ -1050,6 +1120,7 @@ struct AutoReg : NonCopyable {
         } \
         CATCH_INTERNAL_STOP_WARNINGS_SUPPRESSION \
         void TestName::test()
+#endif
     #define INTERNAL_CATCH_TEST_CASE_METHOD( ClassName, ... ) \
         INTERNAL_CATCH_TEST_CASE_METHOD2( INTERNAL_CATCH_UNIQUE_NAME( ____C_A_T_C_H____T_E_S_T____ ), ClassName, __VA_ARGS__ )
 
@@ -2413,6 +2484,36 @@ namespace Catch {
     struct BenchmarkStats;
 #endif // CATCH_CONFIG_ENABLE_BENCHMARKING
 
+    namespace Detail {
+        // When set, captures the test cases' output in place of RedirectedStreams, whatever the
+        // reporter's preferences, and only keeps it for the test cases that fail
+        struct IOutputCapture {
+            virtual ~IOutputCapture() = default;
+            virtual void start() = 0;
+            // Appends what was written since start()
+            virtual void stop( std::string& redirectedCout, std::string& redirectedCerr ) = 0;
+        };
+
+        inline IOutputCapture*& outputCapture() {
+            static IOutputCapture* capture = nullptr;
+            return capture;
+        }
+
+        class OutputCaptureScope {
+            IOutputCapture& m_capture;
+            std::string& m_redirectedCout;
+            std::string& m_redirectedCerr;
+        public:
+            OutputCaptureScope( IOutputCapture& capture, std::string& redirectedCout, std::string& redirectedCerr )
+            :   m_capture( capture ), m_redirectedCout( redirectedCout ), m_redirectedCerr( redirectedCerr ) {
+                m_capture.start();
+            }
+            ~OutputCaptureScope() {
+                m_capture.stop( m_redirectedCout, m_redirectedCerr );
+            }
+        };
+    }
+
     struct IResultCapture {
 
         virtual ~IResultCapture();
@@ -2568,7 +2669,9 @@ namespace Catch {
         bool operator == ( MessageInfo const& other ) const;
         bool operator < ( MessageInfo const& other ) const;
     private:
-        static unsigned int globalCount;
+        // Per thread, as INFO and CAPTURE can be used on several threads at once (see
+        // catch-extensions/parallel-session.hpp); a sequence only has to be unique within a RunContext
+        static thread_local unsigned int globalCount;
     };
 
     struct MessageStream {
@@ -4316,7 +4419,9 @@ namespace Catch {
         virtual void setConfig( IConfigPtr const& config ) = 0;
 
     private:
-        static IMutableContext *currentContext;
+        // One context per thread, so test cases can run on several threads at once,
+        // each with its own RunContext (see catch-extensions/parallel-session.hpp)
+        static thread_local IMutableContext *currentContext;
         friend IMutableContext& getCurrentMutableContext();
         friend void cleanUpContext();
         static void createContext();
@@ -4767,6 +4872,12 @@ namespace Catch {
                             std::string const& className,
                             NameAndTags const& nameAndTags,
                             SourceLineInfo const& lineInfo );
+
+    namespace Detail {
+        // Runs testCases, in order, in a RunContext of their own, whose results go nowhere, and then
+        // puts the current one back. For checking what Catch keeps, and frees, between test cases.
+        Totals runTestCasesInIsolation( std::vector<TestCase> const& testCases );
+    }
 }
 
 #ifdef __clang__
@@ -5032,6 +5143,11 @@ namespace Catch
         virtual ~WildcardPattern() = default;
         virtual bool matches( std::string const& str ) const;
 
+        // Whether it only matches (normalised) strings equal to pattern(), or starting with it
+        bool isExact() const { return m_wildcard == NoWildcard; }
+        bool isPrefix() const { return m_wildcard == WildcardAtEnd; }
+        std::string const& pattern() const { return m_pattern; }
+
     private:
         std::string normaliseString( std::string const& str ) const;
         CaseSensitive::Choice m_caseSensitivity;
@@ -5044,17 +5160,36 @@ namespace Catch
 #include <string>
 #include <vector>
 #include <memory>
+#include <map>
 
 namespace Catch {
 
     struct IConfig;
 
+    // The test cases by (lower case, trimmed) name and by tag, so that TestSpec only has to match
+    // a filter against the test cases that have its name or tag, rather than against all of them
+    class TestCaseIndex {
+    public:
+        explicit TestCaseIndex( std::vector<TestCase> const& testCases );
+
+        // Positions in testCases, in ascending order
+        std::vector<std::size_t> withName( std::string const& name ) const;
+        std::vector<std::size_t> withNamePrefix( std::string const& prefix ) const;
+        std::vector<std::size_t> withTag( std::string const& lcaseTag ) const;
+
+    private:
+        std::vector<std::pair<std::string, std::size_t>> m_names;
+        std::map<std::string, std::vector<std::size_t>> m_tags;
+    };
+
     class TestSpec {
         class Pattern {
         public:
             explicit Pattern( std::string const& name );
             virtual ~Pattern();
             virtual bool matches( TestCaseInfo const& testCase ) const = 0;
+            // The only test cases it can match, if the index can tell
+            virtual bool candidates( TestCaseIndex const& index, std::vector<std::size_t>& positions ) const;
             std::string const& name() const;
         private:
             std::string const m_name;
@@ -5065,6 +5200,7 @@ namespace Catch {
         public:
             explicit NamePattern( std::string const& name, std::string const& filterString );
             bool matches( TestCaseInfo const& testCase ) const override;
+            bool candidates( TestCaseIndex const& index, std::vector<std::size_t>& positions ) const override;
         private:
             WildcardPattern m_wildcardPattern;
         };
@@ -5073,6 +5209,7 @@ namespace Catch {
         public:
             explicit TagPattern( std::string const& tag, std::string const& filterString );
             bool matches( TestCaseInfo const& testCase ) const override;
+            bool candidates( TestCaseIndex const& index, std::vector<std::size_t>& positions ) const override;
         private:
             std::string m_tag;
         };
@@ -5089,6 +5226,8 @@ namespace Catch {
             std::vector<PatternPtr> m_patterns;
 
             bool matches( TestCaseInfo const& testCase ) const;
+            // Those of the pattern with the fewest
+            bool candidates( TestCaseIndex const& index, std::vector<std::size_t>& positions ) const;
             std::string name() const;
         };
 
@@ -5429,6 +5568,9 @@ namespace Catch {
     struct ReporterPreferences {
         bool shouldRedirectStdOut = false;
         bool shouldReportAllAssertions = false;
+        // Backported from Catch 3: without it, RunContext doesn't send assertionStarting events, so a
+        // passing assertion that nothing reports only bumps a counter. The reporter bases turn it off.
+        bool shouldReportAllAssertionStarts = true;
     };
 
     template<typename T>
@@ -5672,6 +5814,7 @@ namespace Catch {
             stream( _config.stream() )
         {
             m_reporterPrefs.shouldRedirectStdOut = false;
+            m_reporterPrefs.shouldReportAllAssertionStarts = false;
             if( !DerivedT::getSupportedVerbosities().count( m_config->verbosity() ) )
                 CATCH_ERROR( "Verbosity level not supported by this reporter" );
         }
@@ -5789,6 +5932,7 @@ namespace Catch {
             stream( _config.stream() )
         {
             m_reporterPrefs.shouldRedirectStdOut = false;
+            m_reporterPrefs.shouldReportAllAssertionStarts = false;
             if( !DerivedT::getSupportedVerbosities().count( m_config->verbosity() ) )
                 CATCH_ERROR( "Verbosity level not supported by this reporter" );
         }
@@ -6136,6 +6280,7 @@ namespace Catch {
 
         void printTotalsDivider(Totals const& totals);
         void printSummaryDivider();
+        void printCapturedOutput(std::string const& name, std::string const& output);
         void printTestFilters();
 
     private:
@@ -6349,7 +6494,9 @@ namespace Catch {
         void benchmarkFailed(std::string const&) override;
 #endif // CATCH_CONFIG_ENABLE_BENCHMARKING
 
-    private:
+    // Protected rather than private so reporters derived from this one can add elements of their own
+    // (not in upstream Catch, see catch-extensions/perf-counters.cpp)
+    protected:
         Timer m_testCaseTimer;
         XmlWriter m_xml;
         int m_sectionDepth = 0;
@@ -7225,6 +7372,18 @@ namespace Catch {
 
 namespace Catch {
     namespace Benchmark {
+        namespace Detail {
+            // Called right before and after a benchmark takes its samples, i.e. without the warm-up
+            // and the analysis around them. Not in upstream Catch: catch-extensions/perf-counters.cpp
+            // uses it to count hardware events for the benchmarked code only.
+            using SamplingHook = void (*)(bool starting);
+
+            inline SamplingHook &samplingHook() {
+                static SamplingHook hook = nullptr;
+                return hook;
+            }
+        }
+
         struct Benchmark {
             Benchmark(std::string &&name)
                 : name(std::move(name)) {}
@@ -7266,9 +7425,11 @@ namespace Catch {
 
                     getResultCapture().benchmarkStarting(info);
 
+                    if (auto hook = Detail::samplingHook()) hook(true);
                     auto samples = user_code([&] {
                         return plan.template run<Clock>(*cfg, env);
                     });
+                    if (auto hook = Detail::samplingHook()) hook(false);
 
                     auto analysis = Detail::analyse(*cfg, env, samples.begin(), samples.end());
                     BenchmarkStats<FloatDuration<Clock>> stats{ info, analysis.samples, analysis.mean, analysis.standard_deviation, analysis.outliers, analysis.outlier_variance };
@@ -7409,7 +7570,8 @@ namespace TestCaseTracking {
 
     struct ITracker;
 
-    using ITrackerPtr = std::shared_ptr<ITracker>;
+    // Owned by the TrackerContext
+    using ITrackerPtr = ITracker*;
 
     struct ITracker {
         virtual ~ITracker();
@@ -7447,11 +7609,52 @@ namespace TestCaseTracking {
             CompletedCycle
         };
 
-        ITrackerPtr m_rootTracker;
+        // The trackers live in blocks of memory from startRun() to endRun(), and the blocks are
+        // reused by the next test case, so only the first test cases allocate trackers
+        struct Block {
+            std::unique_ptr<char[]> memory;
+            std::size_t size;
+        };
+        std::vector<Block> m_blocks;
+        std::size_t m_block = 0;
+        std::size_t m_blockUsed = 0;
+        std::vector<ITracker*> m_trackers;
+
+        // The trackers by parent, location and name, so that finding a section's tracker when it's
+        // entered doesn't depend on how many siblings it has. Open addressing, with erased children
+        // (see TrackerBase::clearChildren) left in until the table grows
+        struct Slot {
+            std::size_t hash;
+            ITracker const* parent;
+            ITracker* tracker;
+            bool erased;
+        };
+        std::vector<Slot> m_slots;
+        std::vector<std::size_t> m_usedSlots;
+
+        ITrackerPtr m_rootTracker = nullptr;
         ITracker* m_currentTracker = nullptr;
         RunState m_runState = NotStarted;
 
+        void* allocate( std::size_t size, std::size_t alignment );
+        void insertSlot( Slot const& slot );
+
     public:
+        TrackerContext() = default;
+        TrackerContext( TrackerContext const& ) = delete;
+        TrackerContext& operator=( TrackerContext const& ) = delete;
+        ~TrackerContext();
+
+        template<typename T, typename... Args>
+        T* make( Args&&... args ) {
+            T* tracker = new( allocate( sizeof( T ), alignof( T ) ) ) T( std::forward<Args>( args )... );
+            m_trackers.push_back( tracker );
+            return tracker;
+        }
+
+        ITracker* findChild( ITracker const& parent, NameAndLocation const& nameAndLocation ) const;
+        void indexChild( ITracker const& parent, ITracker* child );
+        void eraseChild( ITracker const& parent, ITracker* child );
 
         ITracker& startRun();
         void endRun();
@@ -7480,8 +7683,12 @@ namespace TestCaseTracking {
         TrackerContext& m_ctx;
         ITracker* m_parent;
         Children m_children;
+        // Children don't become incomplete again, so close() only looks from the first one that isn't complete
+        std::size_t m_completeChildren = 0;
         CycleState m_runState = NotStarted;
 
+        void clearChildren();
+
     public:
         TrackerBase( NameAndLocation const& nameAndLocation, TrackerContext& ctx, ITracker* parent );
 
@@ -7988,6 +8195,12 @@ namespace Catch {
 
         Totals runTest(TestCase const& testCase);
 
+        // For test cases that ran on another RunContext and were reported through this one's reporter
+        void addTotals( Totals const& deltaTotals );
+
+        // Signal handlers are process wide, only one RunContext at a time may install them
+        void setHandleFatalConditions( bool handleFatalConditions );
+
         IConfigPtr config() const;
         IStreamingReporter& reporter() const;
 
@@ -8090,7 +8303,9 @@ namespace Catch {
         TrackerContext m_trackerContext;
         bool m_lastAssertionPassed = false;
         bool m_shouldReportUnexpected = true;
+        bool m_handleFatalConditions = true;
         bool m_includeSuccessfulResults;
+        bool m_reportAssertionStarts;
     };
 
     void seedRng(IConfig const& config);
@@ -10208,7 +10423,7 @@ namespace Catch {
         IResultCapture* m_resultCapture = nullptr;
     };
 
-    IMutableContext *IMutableContext::currentContext = nullptr;
+    thread_local IMutableContext *IMutableContext::currentContext = nullptr;
 
     void IMutableContext::createContext()
     {
@@ -10714,7 +10929,7 @@ namespace Catch {
 
     // 32kb for the alternate stack seems to be sufficient. However, this value
     // is experimentally determined, so that's not guaranteed.
-    static constexpr std::size_t sigStackSize = 32768 >= MINSIGSTKSZ ? 32768 : MINSIGSTKSZ;
+    static constexpr std::size_t sigStackSize = 32768;
 
     static SignalDefs signalDefs[] = {
         { SIGINT,  "SIGINT - Terminal interrupt signal" },
@@ -11680,7 +11895,7 @@ namespace Catch {
     }
 
     // This may need protecting if threading support is added
-    unsigned int MessageInfo::globalCount = 0;
+    thread_local unsigned int MessageInfo::globalCount = 0;
 
     ////////////////////////////////////////////////////////////////////////////
 
@@ -12148,11 +12363,19 @@ namespace Catch {
 
         std::vector<TestCase> const& getAllTests() const override;
         std::vector<TestCase> const& getAllTestsSorted( IConfig const& config ) const override;
+        TestCaseIndex const& getIndex( std::vector<TestCase> const& testCases ) const override;
 
     private:
+        // The test cases in the catch_test_table section, see CATCH_CONFIG_LAZY_REGISTRATION
+        void registerTableTests() const;
+
         std::vector<TestCase> m_functions;
+        mutable bool m_tableRegistered = false;
         mutable RunTests::InWhatOrder m_currentSortOrder = RunTests::InDeclarationOrder;
         mutable std::vector<TestCase> m_sortedFunctions;
+        mutable std::vector<TestCase> const* m_indexedTests = nullptr;
+        mutable std::size_t m_indexedSize = 0;
+        mutable std::unique_ptr<TestCaseIndex> m_index;
         std::size_t m_unnamedCount = 0;
         std::ios_base::Init m_ostreamInit; // Forces cout/ cerr to be initialised
     };
@@ -12433,16 +12656,16 @@ namespace Catch {
             ~GeneratorTracker();
 
             static GeneratorTracker& acquire( TrackerContext& ctx, TestCaseTracking::NameAndLocation const& nameAndLocation ) {
-                std::shared_ptr<GeneratorTracker> tracker;
+                GeneratorTracker* tracker;
 
                 ITracker& currentTracker = ctx.currentTracker();
                 if( TestCaseTracking::ITrackerPtr childTracker = currentTracker.findChild( nameAndLocation ) ) {
                     assert( childTracker );
                     assert( childTracker->isGeneratorTracker() );
-                    tracker = std::static_pointer_cast<GeneratorTracker>( childTracker );
+                    tracker = static_cast<GeneratorTracker*>( childTracker );
                 }
                 else {
-                    tracker = std::make_shared<GeneratorTracker>( nameAndLocation, ctx, &currentTracker );
+                    tracker = ctx.make<GeneratorTracker>( nameAndLocation, ctx, &currentTracker );
                     currentTracker.addChild( tracker );
                 }
 
@@ -12462,7 +12685,7 @@ namespace Catch {
                 TrackerBase::close();
                 // Generator interface only finds out if it has another item on atual move
                 if (m_runState == CompletedSuccessfully && m_generator->next()) {
-                    m_children.clear();
+                    clearChildren();
                     m_runState = Executing;
                 }
             }
@@ -12484,7 +12707,8 @@ namespace Catch {
         m_config(_config),
         m_reporter(std::move(reporter)),
         m_lastAssertionInfo{ StringRef(), SourceLineInfo("",0), StringRef(), ResultDisposition::Normal },
-        m_includeSuccessfulResults( m_config->includeSuccessfulResults() || m_reporter->getPreferences().shouldReportAllAssertions )
+        m_includeSuccessfulResults( m_config->includeSuccessfulResults() || m_reporter->getPreferences().shouldReportAllAssertions ),
+        m_reportAssertionStarts( m_reporter->getPreferences().shouldReportAllAssertionStarts )
     {
         m_context.setRunner(this);
         m_context.setConfig(m_config);
@@ -12524,6 +12748,8 @@ namespace Catch {
             m_testCaseTracker = &SectionTracker::acquire(m_trackerContext, TestCaseTracking::NameAndLocation(testInfo.name, testInfo.lineInfo));
             runCurrentTest(redirectedCout, redirectedCerr);
         } while (!m_testCaseTracker->isSuccessfullyCompleted() && !aborting());
+        m_testCaseTracker = nullptr;
+        m_trackerContext.endRun();
 
         Totals deltaTotals = m_totals.delta(prevTotals);
         if (testInfo.expectedToFail() && deltaTotals.testCases.passed > 0) {
@@ -12531,6 +12757,10 @@ namespace Catch {
             deltaTotals.testCases.passed--;
             deltaTotals.testCases.failed++;
         }
+        if (Detail::outputCapture() && deltaTotals.testCases.failed == 0) {
+            redirectedCout.clear();
+            redirectedCerr.clear();
+        }
         m_totals.testCases += deltaTotals.testCases;
         m_reporter->testCaseEnded(TestCaseStats(testInfo,
                                   deltaTotals,
@@ -12552,6 +12782,14 @@ namespace Catch {
         return *m_reporter;
     }
 
+    void RunContext::addTotals( Totals const& deltaTotals ) {
+        m_totals += deltaTotals;
+    }
+
+    void RunContext::setHandleFatalConditions( bool handleFatalConditions ) {
+        m_handleFatalConditions = handleFatalConditions;
+    }
+
     void RunContext::assertionEnded(AssertionResult const & result) {
         if (result.getResultType() == ResultWas::Ok) {
             m_totals.assertions.passed++;
@@ -12683,6 +12921,13 @@ namespace Catch {
     }
 
     void RunContext::handleFatalErrorCondition( StringRef message ) {
+        // What the test case wrote before it crashed
+        std::string redirectedCout;
+        std::string redirectedCerr;
+        if (auto capture = Detail::outputCapture()) {
+            capture->stop(redirectedCout, redirectedCerr);
+        }
+
         // First notify reporter that bad things happened
         m_reporter->fatalErrorEncountered(message);
 
@@ -12712,8 +12957,8 @@ namespace Catch {
         deltaTotals.assertions.failed = 1;
         m_reporter->testCaseEnded(TestCaseStats(testInfo,
                                   deltaTotals,
-                                  std::string(),
-                                  std::string(),
+                                  redirectedCout,
+                                  redirectedCerr,
                                   false));
         m_totals.testCases.failed++;
         testGroupEnded(std::string(), m_totals, 1, 1);
@@ -12748,7 +12993,11 @@ namespace Catch {
 
         Timer timer;
         CATCH_TRY {
-            if (m_reporter->getPreferences().shouldRedirectStdOut) {
+            if (auto capture = Detail::outputCapture()) {
+                Detail::OutputCaptureScope captureScope(*capture, redirectedCout, redirectedCerr);
+                timer.start();
+                invokeActiveTestCase();
+            } else if (m_reporter->getPreferences().shouldRedirectStdOut) {
 #if !defined(CATCH_CONFIG_EXPERIMENTAL_REDIRECT)
                 RedirectedStreams redirectedStreams(redirectedCout, redirectedCerr);
 
@@ -12787,6 +13036,10 @@ namespace Catch {
     }
 
     void RunContext::invokeActiveTestCase() {
+        if( !m_handleFatalConditions ) {
+            m_activeTestCase->invoke();
+            return;
+        }
         FatalConditionHandler fatalConditionHandler; // Handle signals
         m_activeTestCase->invoke();
         fatalConditionHandler.reset();
@@ -12808,7 +13061,8 @@ namespace Catch {
         ITransientExpression const& expr,
         AssertionReaction& reaction
     ) {
-        m_reporter->assertionStarting( info );
+        if( m_reportAssertionStarts )
+            m_reporter->assertionStarting( info );
 
         bool negated = isFalseTest( info.resultDisposition );
         bool result = expr.getResult() != negated;
@@ -12847,7 +13101,8 @@ namespace Catch {
             StringRef const& message,
             AssertionReaction& reaction
     ) {
-        m_reporter->assertionStarting( info );
+        if( m_reportAssertionStarts )
+            m_reporter->assertionStarting( info );
 
         m_lastAssertionInfo = info;
 
@@ -12927,6 +13182,49 @@ namespace Catch {
         return getCurrentContext().getConfig()->rngSeed();
     }
 
+    namespace Detail {
+        namespace {
+            // The RunContext's constructor takes the current context over, and nothing gives it back
+            class CurrentRunScope {
+                IMutableContext& m_context;
+                IResultCapture* m_resultCapture;
+                IRunner* m_runner;
+                IConfigPtr m_config;
+                IOutputCapture* m_outputCapture;
+            public:
+                CurrentRunScope()
+                :   m_context( getCurrentMutableContext() ),
+                    m_resultCapture( m_context.getResultCapture() ),
+                    m_runner( m_context.getRunner() ),
+                    m_config( m_context.getConfig() ),
+                    m_outputCapture( outputCapture() )
+                {
+                    // The outer test case's output is being captured already
+                    outputCapture() = nullptr;
+                }
+                ~CurrentRunScope() {
+                    m_context.setResultCapture( m_resultCapture );
+                    m_context.setRunner( m_runner );
+                    m_context.setConfig( m_config );
+                    outputCapture() = m_outputCapture;
+                }
+            };
+        }
+
+        Totals runTestCasesInIsolation( std::vector<TestCase> const& testCases ) {
+            CurrentRunScope scope;
+            auto config = std::make_shared<Config>( ConfigData() );
+            std::ostringstream discarded;
+            RunContext context( config, IStreamingReporterPtr( new TestEventListenerBase( ReporterConfig( config, discarded ) ) ) );
+            // Catch's signal handlers are installed once, by the outer test case
+            context.setHandleFatalConditions( false );
+            Totals totals;
+            for( auto const& testCase : testCases )
+                totals += context.runTest( testCase );
+            return totals;
+        }
+    }
+
 }
 // end catch_run_context.cpp
 // start catch_section.cpp
@@ -13537,15 +13835,21 @@ namespace Catch {
         }
     };
 
+    // One pool per thread, like the context
+    static StringStreams& threadStringStreams() {
+        static thread_local StringStreams streams;
+        return streams;
+    }
+
     ReusableStringStream::ReusableStringStream()
-    :   m_index( Singleton<StringStreams>::getMutable().add() ),
-        m_oss( Singleton<StringStreams>::getMutable().m_streams[m_index].get() )
+    :   m_index( threadStringStreams().add() ),
+        m_oss( threadStringStreams().m_streams[m_index].get() )
     {}
 
     ReusableStringStream::~ReusableStringStream() {
         static_cast<std::ostringstream*>( m_oss )->str("");
         m_oss->clear();
-        Singleton<StringStreams>::getMutable().release( m_index );
+        threadStringStreams().release( m_index );
     }
 
     auto ReusableStringStream::str() const -> std::string {
@@ -13949,6 +14253,15 @@ namespace Catch {
 // start catch_test_case_registry_impl.cpp
 
 #include <sstream>
+#include <cstring>
+
+#if defined(CATCH_INTERNAL_CONFIG_LAZY_REGISTRATION)
+// Defined by the linker, and weak so that a program without a single table entry still links
+extern "C" {
+    extern Catch::Detail::TableEntry const* const __start_catch_test_table[] __attribute__((weak));
+    extern Catch::Detail::TableEntry const* const __stop_catch_test_table[] __attribute__((weak));
+}
+#endif
 
 namespace Catch {
 
@@ -13992,12 +14305,22 @@ namespace Catch {
 
     std::vector<TestCase> filterTests( std::vector<TestCase> const& testCases, TestSpec const& testSpec, IConfig const& config ) {
         std::vector<TestCase> filtered;
-        filtered.reserve( testCases.size() );
-        for (auto const& testCase : testCases) {
-            if ((!testSpec.hasFilters() && !testCase.isHidden()) ||
-                (testSpec.hasFilters() && matchTest(testCase, testSpec, config))) {
-                filtered.push_back(testCase);
+        if (!testSpec.hasFilters()) {
+            filtered.reserve( testCases.size() );
+            for (auto const& testCase : testCases) {
+                if (!testCase.isHidden()) {
+                    filtered.push_back(testCase);
+                }
             }
+            return filtered;
+        }
+        // Pointers into testCases, so in its order
+        std::set<TestCase const*> matched;
+        for (auto const& match : testSpec.matchesByFilter(testCases, config)) {
+            matched.insert(match.tests.begin(), match.tests.end());
+        }
+        for (auto testCase : matched) {
+            filtered.push_back(*testCase);
         }
         return filtered;
     }
@@ -14016,18 +14339,60 @@ namespace Catch {
     }
 
     std::vector<TestCase> const& TestRegistry::getAllTests() const {
+        registerTableTests();
         return m_functions;
     }
     std::vector<TestCase> const& TestRegistry::getAllTestsSorted( IConfig const& config ) const {
+        registerTableTests();
         if( m_sortedFunctions.empty() )
             enforceNoDuplicateTestCases( m_functions );
 
         if(  m_currentSortOrder != config.runOrder() || m_sortedFunctions.empty() ) {
             m_sortedFunctions = sortTests( config, m_functions );
             m_currentSortOrder = config.runOrder();
+            m_index.reset();
         }
         return m_sortedFunctions;
     }
+    TestCaseIndex const& TestRegistry::getIndex( std::vector<TestCase> const& testCases ) const {
+        // Any other vector could be gone by the next call, and another one be where it was
+        bool const own = &testCases == &m_functions || &testCases == &m_sortedFunctions;
+        if( !own || !m_index || m_indexedTests != &testCases || m_indexedSize != testCases.size() ) {
+            m_index.reset( new TestCaseIndex( testCases ) );
+            m_indexedTests = &testCases;
+            m_indexedSize = testCases.size();
+        }
+        return *m_index;
+    }
+
+    void TestRegistry::registerTableTests() const {
+#if defined(CATCH_INTERNAL_CONFIG_LAZY_REGISTRATION)
+        if( m_tableRegistered )
+            return;
+        m_tableRegistered = true;
+        if( !__start_catch_test_table )
+            return;
+        std::vector<Detail::TableEntry const*> entries( __start_catch_test_table, __stop_catch_test_table );
+        // Each object file's entries are together, but not necessarily in the order they're declared in
+        auto byLine = []( Detail::TableEntry const* lhs, Detail::TableEntry const* rhs ) { return lhs->line < rhs->line; };
+        for( auto first = entries.begin(); first != entries.end(); ) {
+            auto last = std::find_if( first, entries.end(), [&]( Detail::TableEntry const* entry ) {
+                return std::strcmp( entry->file, (*first)->file ) != 0;
+            } );
+            std::sort( first, last, byLine );
+            first = last;
+        }
+        auto& registry = const_cast<TestRegistry&>( *this );
+        for( auto entry : entries ) {
+            registry.registerTest(
+                makeTestCase(
+                    entry->makeInvoker(),
+                    extractClassName( entry->className ),
+                    NameAndTags( entry->nameAndTags.name, entry->nameAndTags.tags ),
+                    SourceLineInfo( entry->file, entry->line ) ) );
+        }
+#endif
+    }
 
     ///////////////////////////////////////////////////////////////////////////
     TestInvokerAsFunction::TestInvokerAsFunction( void(*testAsFunction)() ) noexcept : m_testAsFunction( testAsFunction ) {}
@@ -14055,6 +14420,8 @@ namespace Catch {
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <functional>
 #include <stdexcept>
 #include <memory>
 #include <sstream>
@@ -14074,21 +14441,107 @@ namespace TestCaseTracking {
 
     ITracker::~ITracker() = default;
 
+    namespace {
+        std::size_t const trackerBlockSize = 16 * 1024;
+
+        std::size_t hashChild( ITracker const& parent, NameAndLocation const& nameAndLocation ) {
+            std::size_t hash = std::hash<std::string>()( nameAndLocation.name );
+            hash ^= reinterpret_cast<std::uintptr_t>( &parent ) + 0x9e3779b9 + ( hash << 6 ) + ( hash >> 2 );
+            hash ^= nameAndLocation.location.line + 0x9e3779b9 + ( hash << 6 ) + ( hash >> 2 );
+            return hash;
+        }
+    }
+
+    TrackerContext::~TrackerContext() {
+        endRun();
+    }
+
+    void* TrackerContext::allocate( std::size_t size, std::size_t alignment ) {
+        for( ; m_block < m_blocks.size(); ++m_block, m_blockUsed = 0 ) {
+            std::size_t offset = ( m_blockUsed + alignment - 1 ) / alignment * alignment;
+            if( offset + size <= m_blocks[m_block].size ) {
+                m_blockUsed = offset + size;
+                return m_blocks[m_block].memory.get() + offset;
+            }
+        }
+        std::size_t blockSize = (std::max)( size, trackerBlockSize );
+        m_blocks.push_back( Block{ std::unique_ptr<char[]>( new char[blockSize] ), blockSize } );
+        m_blockUsed = size;
+        return m_blocks.back().memory.get();
+    }
+
+    void TrackerContext::insertSlot( Slot const& slot ) {
+        std::size_t mask = m_slots.size() - 1;
+        std::size_t i = slot.hash & mask;
+        while( m_slots[i].tracker )
+            i = ( i + 1 ) & mask;
+        m_slots[i] = slot;
+        m_usedSlots.push_back( i );
+    }
+
+    ITracker* TrackerContext::findChild( ITracker const& parent, NameAndLocation const& nameAndLocation ) const {
+        if( m_slots.empty() )
+            return nullptr;
+        std::size_t hash = hashChild( parent, nameAndLocation );
+        std::size_t mask = m_slots.size() - 1;
+        for( std::size_t i = hash & mask; m_slots[i].tracker; i = ( i + 1 ) & mask ) {
+            Slot const& slot = m_slots[i];
+            if( slot.hash == hash && slot.parent == &parent && !slot.erased &&
+                slot.tracker->nameAndLocation().location == nameAndLocation.location &&
+                slot.tracker->nameAndLocation().name == nameAndLocation.name )
+                return slot.tracker;
+        }
+        return nullptr;
+    }
+
+    void TrackerContext::indexChild( ITracker const& parent, ITracker* child ) {
+        if( ( m_usedSlots.size() + 1 ) * 2 > m_slots.size() ) {
+            std::vector<Slot> slots( (std::max)( m_slots.size() * 2, std::size_t( 64 ) ), Slot{ 0, nullptr, nullptr, false } );
+            std::swap( slots, m_slots );
+            m_usedSlots.clear();
+            for( auto const& slot : slots )
+                if( slot.tracker && !slot.erased )
+                    insertSlot( slot );
+        }
+        insertSlot( Slot{ hashChild( parent, child->nameAndLocation() ), &parent, child, false } );
+    }
+
+    void TrackerContext::eraseChild( ITracker const& parent, ITracker* child ) {
+        std::size_t mask = m_slots.size() - 1;
+        for( std::size_t i = hashChild( parent, child->nameAndLocation() ) & mask; m_slots[i].tracker; i = ( i + 1 ) & mask ) {
+            if( m_slots[i].tracker == child ) {
+                m_slots[i].erased = true;
+                return;
+            }
+        }
+    }
+
     ITracker& TrackerContext::startRun() {
-        m_rootTracker = std::make_shared<SectionTracker>( NameAndLocation( "{root}", CATCH_INTERNAL_LINEINFO ), *this, nullptr );
+        // In case the last run ended with an exception
+        if( m_runState != NotStarted )
+            endRun();
+        m_rootTracker = make<SectionTracker>( NameAndLocation( "{root}", CATCH_INTERNAL_LINEINFO ), *this, nullptr );
         m_currentTracker = nullptr;
         m_runState = Executing;
         return *m_rootTracker;
     }
 
     void TrackerContext::endRun() {
-        m_rootTracker.reset();
+        for( auto it = m_trackers.rbegin(); it != m_trackers.rend(); ++it )
+            (*it)->~ITracker();
+        m_trackers.clear();
+        m_block = 0;
+        m_blockUsed = 0;
+        for( auto i : m_usedSlots )
+            m_slots[i] = Slot{ 0, nullptr, nullptr, false };
+        m_usedSlots.clear();
+        m_rootTracker = nullptr;
         m_currentTracker = nullptr;
         m_runState = NotStarted;
     }
 
     void TrackerContext::startCycle() {
-        m_currentTracker = m_rootTracker.get();
+        m_currentTracker = m_rootTracker;
         m_runState = Executing;
     }
     void TrackerContext::completeCycle() {
@@ -14129,18 +14582,18 @@ namespace TestCaseTracking {
 
     void TrackerBase::addChild( ITrackerPtr const& child ) {
         m_children.push_back( child );
+        m_ctx.indexChild( *this, child );
     }
 
     ITrackerPtr TrackerBase::findChild( NameAndLocation const& nameAndLocation ) {
-        auto it = std::find_if( m_children.begin(), m_children.end(),
-            [&nameAndLocation]( ITrackerPtr const& tracker ){
-                return
-                    tracker->nameAndLocation().location == nameAndLocation.location &&
-                    tracker->nameAndLocation().name == nameAndLocation.name;
-            } );
-        return( it != m_children.end() )
-            ? *it
-            : nullptr;
+        return m_ctx.findChild( *this, nameAndLocation );
+    }
+
+    void TrackerBase::clearChildren() {
+        for( auto child : m_children )
+            m_ctx.eraseChild( *this, child );
+        m_children.clear();
+        m_completeChildren = 0;
     }
     ITracker& TrackerBase::parent() {
         assert( m_parent ); // Should always be non-null except for root
@@ -14179,7 +14632,9 @@ namespace TestCaseTracking {
                 m_runState = CompletedSuccessfully;
                 break;
             case ExecutingChildren:
-                if( std::all_of(m_children.begin(), m_children.end(), [](ITrackerPtr const& t){ return t->isComplete(); }) )
+                while( m_completeChildren < m_children.size() && m_children[m_completeChildren]->isComplete() )
+                    ++m_completeChildren;
+                if( m_completeChildren == m_children.size() )
                     m_runState = CompletedSuccessfully;
                 break;
 
@@ -14239,16 +14694,16 @@ namespace TestCaseTracking {
     bool SectionTracker::isSectionTracker() const { return true; }
 
     SectionTracker& SectionTracker::acquire( TrackerContext& ctx, NameAndLocation const& nameAndLocation ) {
-        std::shared_ptr<SectionTracker> section;
+        SectionTracker* section;
 
         ITracker& currentTracker = ctx.currentTracker();
         if( ITrackerPtr childTracker = currentTracker.findChild( nameAndLocation ) ) {
             assert( childTracker );
             assert( childTracker->isSectionTracker() );
-            section = std::static_pointer_cast<SectionTracker>( childTracker );
+            section = static_cast<SectionTracker*>( childTracker );
         }
         else {
-            section = std::make_shared<SectionTracker>( nameAndLocation, ctx, &currentTracker );
+            section = ctx.make<SectionTracker>( nameAndLocation, ctx, &currentTracker );
             currentTracker.addChild( section );
         }
         if( !ctx.completedCycle() )
@@ -14329,6 +14784,10 @@ namespace Catch {
 
     TestSpec::Pattern::~Pattern() = default;
 
+    bool TestSpec::Pattern::candidates( TestCaseIndex const&, std::vector<std::size_t>& ) const {
+        return false;
+    }
+
     std::string const& TestSpec::Pattern::name() const {
         return m_name;
     }
@@ -14342,6 +14801,16 @@ namespace Catch {
         return m_wildcardPattern.matches( testCase.name );
     }
 
+    bool TestSpec::NamePattern::candidates( TestCaseIndex const& index, std::vector<std::size_t>& positions ) const {
+        if( m_wildcardPattern.isExact() )
+            positions = index.withName( m_wildcardPattern.pattern() );
+        else if( m_wildcardPattern.isPrefix() )
+            positions = index.withNamePrefix( m_wildcardPattern.pattern() );
+        else
+            return false;
+        return true;
+    }
+
     TestSpec::TagPattern::TagPattern( std::string const& tag, std::string const& filterString )
     : Pattern( filterString )
     , m_tag( toLower( tag ) )
@@ -14353,6 +14822,11 @@ namespace Catch {
                          m_tag) != end(testCase.lcaseTags);
     }
 
+    bool TestSpec::TagPattern::candidates( TestCaseIndex const& index, std::vector<std::size_t>& positions ) const {
+        positions = index.withTag( m_tag );
+        return true;
+    }
+
     TestSpec::ExcludedPattern::ExcludedPattern( PatternPtr const& underlyingPattern )
     : Pattern( underlyingPattern->name() )
     , m_underlyingPattern( underlyingPattern )
@@ -14366,6 +14840,18 @@ namespace Catch {
         return std::all_of( m_patterns.begin(), m_patterns.end(), [&]( PatternPtr const& p ){ return p->matches( testCase ); } );
     }
 
+    bool TestSpec::Filter::candidates( TestCaseIndex const& index, std::vector<std::size_t>& positions ) const {
+        bool found = false;
+        std::vector<std::size_t> current;
+        for( auto const& p : m_patterns ) {
+            if( p->candidates( index, current ) && ( !found || current.size() < positions.size() ) ) {
+                positions.swap( current );
+                found = true;
+            }
+        }
+        return found;
+    }
+
     std::string TestSpec::Filter::name() const {
         std::string name;
         for( auto const& p : m_patterns )
@@ -14383,17 +14869,57 @@ namespace Catch {
 
     TestSpec::Matches TestSpec::matchesByFilter( std::vector<TestCase> const& testCases, IConfig const& config ) const
     {
+        auto const& index = getRegistryHub().getTestCaseRegistry().getIndex( testCases );
         Matches matches( m_filters.size() );
         std::transform( m_filters.begin(), m_filters.end(), matches.begin(), [&]( Filter const& filter ){
             std::vector<TestCase const*> currentMatches;
-            for( auto const& test : testCases )
-                if( isThrowSafe( test, config ) && filter.matches( test ) )
-                    currentMatches.emplace_back( &test );
+            std::vector<std::size_t> candidates;
+            if( filter.candidates( index, candidates ) ) {
+                for( auto position : candidates )
+                    if( isThrowSafe( testCases[position], config ) && filter.matches( testCases[position] ) )
+                        currentMatches.emplace_back( &testCases[position] );
+            } else {
+                for( auto const& test : testCases )
+                    if( isThrowSafe( test, config ) && filter.matches( test ) )
+                        currentMatches.emplace_back( &test );
+            }
             return FilterMatch{ filter.name(), currentMatches };
         } );
         return matches;
     }
 
+    TestCaseIndex::TestCaseIndex( std::vector<TestCase> const& testCases ) {
+        m_names.reserve( testCases.size() );
+        for( std::size_t i = 0; i < testCases.size(); ++i ) {
+            m_names.emplace_back( trim( toLower( testCases[i].name ) ), i );
+            for( auto const& tag : testCases[i].lcaseTags )
+                m_tags[tag].push_back( i );
+        }
+        std::sort( m_names.begin(), m_names.end() );
+    }
+
+    std::vector<std::size_t> TestCaseIndex::withName( std::string const& name ) const {
+        std::vector<std::size_t> positions;
+        auto it = std::lower_bound( m_names.begin(), m_names.end(), std::make_pair( name, std::size_t( 0 ) ) );
+        for( ; it != m_names.end() && it->first == name; ++it )
+            positions.push_back( it->second );
+        return positions;
+    }
+
+    std::vector<std::size_t> TestCaseIndex::withNamePrefix( std::string const& prefix ) const {
+        std::vector<std::size_t> positions;
+        auto it = std::lower_bound( m_names.begin(), m_names.end(), std::make_pair( prefix, std::size_t( 0 ) ) );
+        for( ; it != m_names.end() && startsWith( it->first, prefix ); ++it )
+            positions.push_back( it->second );
+        std::sort( positions.begin(), positions.end() );
+        return positions;
+    }
+
+    std::vector<std::size_t> TestCaseIndex::withTag( std::string const& lcaseTag ) const {
+        auto it = m_tags.find( lcaseTag );
+        return it == m_tags.end() ? std::vector<std::size_t>() : it->second;
+    }
+
     const TestSpec::vectorStrings& TestSpec::getInvalidArgs() const{
         return  (m_invalidArgs);
     }
@@ -16234,6 +16760,9 @@ void ConsoleReporter::benchmarkFailed(std::string const& error) {
 
 void ConsoleReporter::testCaseEnded(TestCaseStats const& _testCaseStats) {
     m_tablePrinter->close();
+    // Only captured (and kept) by Detail::outputCapture()
+    printCapturedOutput("stdout", _testCaseStats.stdOut);
+    printCapturedOutput("stderr", _testCaseStats.stdErr);
     StreamingReporterBase::testCaseEnded(_testCaseStats);
     m_headerPrinted = false;
 }
@@ -16435,6 +16964,15 @@ void ConsoleReporter::printSummaryDivider() {
     stream << getLineOfChars<'-'>() << '\n';
 }
 
+void ConsoleReporter::printCapturedOutput(std::string const& name, std::string const& output) {
+    if (output.empty())
+        return;
+    stream << "Captured " << name << ":\n" << output;
+    if (output.back() != '\n')
+        stream << '\n';
+    stream << '\n';
+}
+
 void ConsoleReporter::printTestFilters() {
     if (m_config->testSpec().hasFilters())
         stream << Colour(Colour::BrightYellow) << "Filters: " << serializeFilters( m_config->getTestsOrTags() ) << '\n';
@@ -16726,18 +17264,26 @@ namespace Catch {
 namespace Catch {
 
     ListeningReporter::ListeningReporter() {
-        // We will assume that listeners will always want all assertions
-        m_preferences.shouldReportAllAssertions = true;
+        // Only what the listeners and the reporter ask for (as in Catch 3), rather than assuming
+        // that listeners want every assertion, which sends every passing assertion through the reporters
+        m_preferences.shouldReportAllAssertions = false;
+        m_preferences.shouldReportAllAssertionStarts = false;
     }
 
     void ListeningReporter::addListener( IStreamingReporterPtr&& listener ) {
+        auto preferences = listener->getPreferences();
+        m_preferences.shouldReportAllAssertions |= preferences.shouldReportAllAssertions;
+        m_preferences.shouldReportAllAssertionStarts |= preferences.shouldReportAllAssertionStarts;
         m_listeners.push_back( std::move( listener ) );
     }
 
     void ListeningReporter::addReporter(IStreamingReporterPtr&& reporter) {
         assert(!m_reporter && "Listening reporter can wrap only 1 real reporter");
         m_reporter = std::move( reporter );
-        m_preferences.shouldRedirectStdOut = m_reporter->getPreferences().shouldRedirectStdOut;
+        auto preferences = m_reporter->getPreferences();
+        m_preferences.shouldRedirectStdOut = preferences.shouldRedirectStdOut;
+        m_preferences.shouldReportAllAssertions |= preferences.shouldReportAllAssertions;
+        m_preferences.shouldReportAllAssertionStarts |= preferences.shouldReportAllAssertionStarts;
     }
 
     ReporterPreferences ListeningReporter::getPreferences() const {
@@ -0,0 +1,44 @@
+#!/usr/bin/env bash
+# Builds the test executable from scratch in each header mode (plain, PCH, unity, PCH + unity)
+# and reports the wall-clock time of the clean build and of an incremental rebuild after
+# touching a single test file.
+#
+# usage: ./compile-times.sh [jobs]
+set -euo pipefail
+
+cd "$(dirname "$0")"
+jobs=${1:-4}
+root=cmake-build-times
+
+now() { date +%s.%N; }
+
+elapsed() {
+  local start=$1
+  awk -v start="$start" -v end="$(now)" 'BEGIN { print end - start }'
+}
+
+printf '%-12s %12s %12s\n' mode clean incremental
+for mode in plain pch unity pch+unity; do
+  pch=OFF
+  unity=OFF
+  [[ $mode == *pch* ]] && pch=ON
+  [[ $mode == *unity* ]] && unity=ON
+
+  dir=$root/$mode
+  rm -rf "$dir"
+  cmake -S . -B "$dir" -DCPP_PLAYGROUND_PCH=$pch -DCPP_PLAYGROUND_UNITY=$unity >/dev/null
+
+  # Don't count the library or catch's main, they're the same in every mode
+  cmake --build "$dir" --target cpp_playground_lib catch_main -- -j "$jobs" >/dev/null
+
+  start=$(now)
+  cmake --build "$dir" --target cpp_playground -- -j "$jobs" >/dev/null
+  clean=$(elapsed "$start")
+
+  touch intro-to-stl.cpp
+  start=$(now)
+  cmake --build "$dir" --target cpp_playground -- -j "$jobs" >/dev/null
+  incremental=$(elapsed "$start")
+
+  printf '%-12s %11.2fs %11.2fs\n' "$mode" "$clean" "$incremental"
+done
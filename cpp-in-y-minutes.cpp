@@ -5,6 +5,7 @@
 // and so I can feel better about their results
 
 #include "catch.hpp"
+#include "catch-extensions/range-assertions.hpp"
 
 // Couldn't name this `main` because that's already been taken by the synthetic `main` from dsjf-test-playground.cpp
 // How do I have both a `main` in my sources and a `main` in my tests? Separate builds?
@@ -83,7 +84,7 @@ int doSomethingWithInts(int a = 1, int b = 4) {
     return a + b;
 }
 
-TEST_CASE("Default arguments", "[default-args]") {
+TEST_CASE("Default arguments", "[default-args][parallel]") {
     REQUIRE(doSomethingWithInts() == 5);
     REQUIRE(doSomethingWithInts(2) == 6);
     REQUIRE(doSomethingWithInts(1, 1) == 2);
@@ -265,80 +266,10 @@ TEST_CASE("Enums") {
 /////////////////////
 
 // First example of classes
-#include <iostream>
-
 // Declare a class.
-// Classes are usually declared in header (.h or .hpp) files.
-class Dog {
-    // Member variables and functions are private by default.
-    std::string name;
-    int weight;
-
-// All members following this are public
-// until "private:" or "protected:" is found.
-public:
-
-    // Default constructor
-    Dog();
-
-    // Member function declarations (implementations to follow)
-    // Note that we use std::string here instead of placing
-    // using namespace std;
-    // above.
-    // Never put a "using namespace" statement in a header.
-    void setName(const std::string &dogsName);
-
-    void setWeight(int dogsWeight);
-
-    // Functions that do not modify the state of the object
-    // should be marked as const
-    // This allows you to call them if given a const reference to the object.
-    // Also note the functions must be explicitly declared as _virtual_
-    // in order to be overridden in derived classes.
-    // Functions are not virtual by default for performance reasons.
-    virtual void print() const;
-
-    // Functions can also be defined inside the class body.
-    // Functions defined as such are automatically inlined.
-    void bark() const {
-        std::cout << name << " barks!\n";
-    }
-
-    // Along with constructors, C++ provides destructors.
-    // These are called when an object is deleted or falls out of scope.
-    // This enables powerful paradigms such as RAII
-    // (see below)
-    // The destructor should be virtual if a class is to be derived from;
-    // if it is not virtual, then the derived class' destructor will
-    // not be called if the object is destroyed through a base-class reference
-    // or pointer.
-    virtual ~Dog();
-
-}; // A semicolon must follow the class definition.
-
-// Class member functions are usually implemented in .cpp files.
-Dog::Dog() {
-    std::cout << "A dog has been constructed!\n";
-}
-
-// Objects (such as strings) should be passed by reference
-// if you are modifying them or const reference if you are not.
-void Dog::setName(const std::string &dogsName) {
-    name = dogsName;
-}
-
-void Dog::setWeight(int dogsWeight) {
-    weight = dogsWeight;
-}
-
-// Notice that "virtual" is only needed in the declaration, not the definition.
-void Dog::print() const {
-    std::cout << "Dog is " << name << " and weighs " << weight << "kg\n";
-}
-
-Dog::~Dog() {
-    std::cout << "Goodbye " << name << "\n";
-}
+// Classes are usually declared in header (.h or .hpp) files,
+// so Dog is declared in dog.hpp and implemented in dog.cpp.
+#include "dog.hpp"
 
 TEST_CASE("Objects") {
     Dog myDog;
@@ -347,38 +278,7 @@ TEST_CASE("Objects") {
     myDog.print();
 }
 
-// Inheritance:
-
-// This class inherits everything public and protected from the Dog class
-// as well as private but may not directly access private members/methods
-// without a public or protected method for doing so
-class OwnedDog : public Dog {
-
-public:
-    void setOwner(const std::string &dogsOwner);
-
-    // Override the behavior of the print function for all OwnedDogs.
-    // See http://en.wikipedia.org/wiki/Polymorphism_(computer_science)#Subtyping
-    // for a more general introduction if you're unfamiliar with
-    // subtype polymorphism.
-    // The override keyword is optional but makes sure you are actually
-    // overriding the method in a base case.
-    void print() const override;
-
-private:
-    std::string owner;
-};
-
-// Meanwhile, in the corresponding .cpp file:
-
-void OwnedDog::setOwner(const std::string &dogsOwner) {
-    owner = dogsOwner;
-}
-
-void OwnedDog::print() const {
-    Dog::print(); // Call the print function in the base Dog class
-    std::cout << "Dog is owned by " << owner << "\n";
-}
+// Inheritance: OwnedDog (also in dog.hpp) inherits everything public and protected from Dog
 
 TEST_CASE("Inheritance") {
     OwnedDog myDog;
@@ -402,7 +302,7 @@ TEST_CASE("Map") {
     }
     std::cout << endl;
     std::vector<int> expected{1, 4, 9, 16, 25, 36, 49, 64, 81};
-    REQUIRE(vec == expected);
+    REQUIRE_RANGE(vec, expected);
 }
 
 TEST_CASE("Filter") {
@@ -418,7 +318,8 @@ TEST_CASE("Filter") {
     }
     std::cout << endl;
     std::vector<int> expectedEvens{2, 4, 6, 8};
-    REQUIRE(evens == expectedEvens);
+    REQUIRE_RANGE(evens, expectedEvens);
+    REQUIRE_ALL_OF(evens, [](int i) { return i % 2 == 0; });
 
     std::vector<int> odds;
     std::copy_if(vec.begin(), vec.end(), std::back_inserter(odds), [](int i) { return i % 2 != 0; });
@@ -427,7 +328,8 @@ TEST_CASE("Filter") {
     }
     std::cout << endl;
     std::vector<int> expectedOdds{1, 3, 5, 7, 9};
-    REQUIRE(odds == expectedOdds);
+    REQUIRE_RANGE(odds, expectedOdds);
+    REQUIRE_ALL_OF(odds, [](int i) { return i % 2 != 0; });
 }
 
 TEST_CASE("Reduce") {
@@ -453,64 +355,8 @@ TEST_CASE("Reduce") {
 
 using namespace std;
 
-class Point {
-public:
-    // Member variables can be given default values in this manner.
-    double x = 0;
-    double y = 0;
-
-    // Define a default constructor which does nothing
-    // but initialize the Point to the default value (0, 0)
-    Point(double a, double b) :
-            x(a),
-            y(b) { /* Do nothing except initialize the values */ };
-
-    // Overload the + operator
-    Point operator+(const Point &rhs) const;
-
-    // Overload the += operator
-    Point &operator+=(const Point &rhs);
-
-    // Overload the - operator
-    Point operator-(const Point &rhs) const;
-
-    // Overload the -= operator
-    Point &operator-=(const Point &rhs);
-
-    // Overload the == operator
-    bool operator==(const Point &rhs) const;
-};
-
-Point Point::operator+(const Point &rhs) const {
-    // Create a new point that is the sum of this one and rhs.
-    return {x + rhs.x, y + rhs.y}; // another way of saying `Point(x + rhs.x, y + rhs.y)`
-}
-
-Point Point::operator-(const Point &rhs) const {
-    return Point(x - rhs.x, y - rhs.y);
-}
-
-// It's good practice to return a reference to the leftmost variable of
-// an assignment. `(a += b) == c` will work this way.
-Point &Point::operator+=(const Point &rhs) {
-    x += rhs.x;
-    y += rhs.y;
-
-    // `this` is a pointer to the object, on which a method is called.
-    return *this;
-}
-
-Point &Point::operator-=(const Point &rhs) {
-    x -= rhs.x;
-    y -= rhs.y;
-
-    return *this;
-}
-
-bool Point::operator==(const Point &rhs) const {
-    return x == rhs.x &&
-           y == rhs.y;
-}
+// Point is declared in point.hpp and its operators are defined in point.cpp
+#include "point.hpp"
 
 TEST_CASE("Operator Overloading") {
     Point up(0, 1);
@@ -532,17 +378,7 @@ TEST_CASE("Operator Overloading") {
 
 // We start with the kind of generic programming you might be familiar with.
 // To define a class or function that takes a type parameter:
-template<class T>
-class Box {
-public:
-    // In this class, T can be used as any other type.
-    T insert(const T t);
-};
-
-template<class T>
-T Box<T>::insert(const T t) {
-    return t;
-}
+#include "box.hpp" // Box<T> lives in a header because the full definition is needed at every instantiation
 
 TEST_CASE("Templates") {
     // During compilation, the compiler actually generates copies of each template
@@ -621,7 +457,7 @@ auto add = [](auto x) {
 };
 auto addone = add(1);
 
-TEST_CASE("Nested Lambdas") {
+TEST_CASE("Nested Lambdas", "[parallel]") {
     REQUIRE(addone(1) == 2);
     REQUIRE(add(1)(1) == 2);
     REQUIRE(add(1)(2) == 3);
@@ -670,76 +506,9 @@ TEST_CASE("Try/Catch with catch-all") {
 // and is the simple concept that a constructor for an object
 // acquires that object's resources and the destructor releases them.
 
-bool doSomethingWithAFile(const FILE *fh) {
-    return true;
-}
-
-bool doSomethingElseWithIt(const FILE *fh) {
-    return true;
-}
-
-// To understand how this is useful,
-// consider a function that uses a C file handle
-void doSomethingWithAFile(const char *filename) {
-    // To begin with, assume nothing can fail
-    FILE *fh = fopen(filename, "r"); // Open the file in read mode.
-
-    doSomethingWithAFile(fh);
-    doSomethingElseWithIt(fh);
-
-    fclose(fh); // Close the file handle
-}
-
-// Unfortunately, things are quickly complicated by error handling.
-// Suppose fopen can fail, and that doSomethingWithTheFile and
-// doSomethingElseWithIt return error codes if they fail.
-// (Exceptions are the preferred way of handling failure,
-//  but some programmers, especially those with a C background,
-//  disagree on the utility of exceptions).
-// We now have to check each call for failure and close the file handle
-// if a problem occurred.
-bool doSomethingWithAFile2(const char *filename) {
-    FILE *fh = fopen(filename, "r"); // Open the file in read mode
-    if (fh == nullptr) { // The returned pointer is null on failure
-        return false; // report that failure to the caller
-    }
-
-    // Assume each function returns false if it failed
-    if (!doSomethingWithAFile(fh)) {
-        fclose(fh); // close the file handle so it doesn't leak
-        return false; // propagate the error
-    }
-    if (!doSomethingElseWithIt(fh)) {
-        fclose(fh); // close the file handle so it doesn't leak
-        return false; // propagate the error
-    }
-
-    fclose(fh); // close the file handle so it doesn't leak
-    return true; // indicate success
-}
-
-// C programmers often clean this up a little bit using goto:
-bool doSomethingWithAFile3(const char *filename) {
-    FILE *fh = fopen(filename, "r");
-    if (fh == nullptr) {
-        return false;
-    }
-
-    if (!doSomethingWithAFile(fh)) {
-        goto failure;
-    }
-    if (!doSomethingElseWithIt(fh)) {
-        goto failure;
-    }
-
-    fclose(fh);
-    return true;
-
-    failure:
-    std::cout << "lol I'm in a goto tag thingy" << endl;
-    fclose(fh);
-    return false;
-}
+// To understand how this is useful, see the C file handle versions
+// of doSomethingWithAFile in raii.cpp (they live in the cpp_playground_lib library).
+#include "raii.hpp"
 
 TEST_CASE("Failure handling without exceptions") {
     REQUIRE(doSomethingWithAFile3("Makefile") == true);
@@ -747,34 +516,8 @@ TEST_CASE("Failure handling without exceptions") {
 }
 
 // If the functions indicate errors using exceptions,
-// things are a little cleaner, but still sub-optimal.
-void doSomethingWithAFile4(const char *filename) {
-    FILE *fh = fopen(filename, "r");
-    if (fh == nullptr) {
-        throw std::runtime_error("Could not open the file.");
-    }
-    try {
-        doSomethingWithAFile(fh);
-        doSomethingElseWithIt(fh);
-    } catch (...) {
-        fclose(fh);
-        throw;
-    }
-
-    fclose(fh);
-}
-
-// Compare this to the use of C++'s file stream class (fstream)
-// fstream uses its destructor to close the file.
-// Recall from above that destructors are automatically called
-// whenever an object falls out of scope.
-void doSomethingWithAFile5(const char *filename) {
-    // ifstream is short for input file stream
-    std::ifstream fh(filename); // Open the file
-
-    // doSomethingWithAFile(fh);
-    // doSomethingElseWithIt(fh);
-} // The file is automatically closed here by the destructor
+// things are a little cleaner, but still sub-optimal: see doSomethingWithAFile4 in raii.cpp.
+// Compare that to doSomethingWithAFile5, which lets std::ifstream close the file in its destructor.
 
 TEST_CASE("Fancy Destructors and Such") {
     doSomethingWithAFile5("Makefile");
@@ -972,7 +715,7 @@ TEST_CASE("Custom Comparator") {
 // For example, consider sorting a vector of pairs using the second
 // value of the pair
 
-TEST_CASE("Lambda Expressions") {
+TEST_CASE("Lambda Expressions", "[parallel]") {
     vector<pair<int, int>> tester;
     tester.push_back(make_pair(3, 6));
     tester.push_back(make_pair(1, 9));
@@ -990,10 +733,7 @@ TEST_CASE("Lambda Expressions") {
         return lhs.second < rhs.second;
     });
 
-    REQUIRE(tester.size() == 3);
-    REQUIRE(tester[0] == make_pair(5, 0));
-    REQUIRE(tester[1] == make_pair(3, 6));
-    REQUIRE(tester[2] == make_pair(1, 9));
+    REQUIRE_RANGE(tester, vector<pair<int, int>>{make_pair(5, 0), make_pair(3, 6), make_pair(1, 9)});
 
     // Notice the syntax of the lambda expression,
     // [] in the lambda is used to "capture" variables
@@ -1028,10 +768,7 @@ TEST_CASE("Lambda Expressions") {
         return weight[lhs] < weight[rhs];
     });
 
-    REQUIRE(dog_ids.size() == 3);
-    REQUIRE(dog_ids[0] == 2);
-    REQUIRE(dog_ids[1] == 0);
-    REQUIRE(dog_ids[2] == 1);
+    REQUIRE_RANGE(dog_ids, vector<int>{2, 0, 1});
 
     // Note we captured "weight" by reference in the above example.
     // More on Lambdas in C++ : http://stackoverflow.com/questions/7627098/what-is-a-lambda-expression-in-c11
@@ -1179,7 +916,7 @@ TEST_CASE("Tuples") {
 // the second argument is executed or evaluated only if the first argument
 // does not suffice to determine the value of the expression
 
-TEST_CASE("Logical Operators") {
+TEST_CASE("Logical Operators", "[parallel]") {
     REQUIRE((true && false) == false);
     REQUIRE((true || false) == true);
     REQUIRE((!true) == false);
@@ -1190,7 +927,7 @@ TEST_CASE("Logical Operators") {
     REQUIRE((not true) == false);
 }
 
-TEST_CASE("Bitwise Operators") {
+TEST_CASE("Bitwise Operators", "[parallel]") {
     // **<<** Left Shift Operator
     // << shifts bits to the left
     REQUIRE((4 << 1) == 8); // Shifts bits of 4 to left by 1 to give 8
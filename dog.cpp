@@ -0,0 +1,34 @@
+#include "dog.hpp"
+
+// Class member functions are usually implemented in .cpp files.
+Dog::Dog() {
+    std::cout << "A dog has been constructed!\n";
+}
+
+// Objects (such as strings) should be passed by reference
+// if you are modifying them or const reference if you are not.
+void Dog::setName(const std::string &dogsName) {
+    name = dogsName;
+}
+
+void Dog::setWeight(int dogsWeight) {
+    weight = dogsWeight;
+}
+
+// Notice that "virtual" is only needed in the declaration, not the definition.
+void Dog::print() const {
+    std::cout << "Dog is " << name << " and weighs " << weight << "kg\n";
+}
+
+Dog::~Dog() {
+    std::cout << "Goodbye " << name << "\n";
+}
+
+void OwnedDog::setOwner(const std::string &dogsOwner) {
+    owner = dogsOwner;
+}
+
+void OwnedDog::print() const {
+    Dog::print(); // Call the print function in the base Dog class
+    std::cout << "Dog is owned by " << owner << "\n";
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+// Declare a class.
+// Classes are usually declared in header (.h or .hpp) files.
+class Dog {
+    // Member variables and functions are private by default.
+    std::string name;
+    int weight;
+
+// All members following this are public
+// until "private:" or "protected:" is found.
+public:
+
+    // Default constructor
+    Dog();
+
+    // Member function declarations (implementations to follow)
+    // Note that we use std::string here instead of placing
+    // using namespace std;
+    // above.
+    // Never put a "using namespace" statement in a header.
+    void setName(const std::string &dogsName);
+
+    void setWeight(int dogsWeight);
+
+    // Functions that do not modify the state of the object
+    // should be marked as const
+    // This allows you to call them if given a const reference to the object.
+    // Also note the functions must be explicitly declared as _virtual_
+    // in order to be overridden in derived classes.
+    // Functions are not virtual by default for performance reasons.
+    virtual void print() const;
+
+    // Functions can also be defined inside the class body.
+    // Functions defined as such are automatically inlined.
+    void bark() const {
+        std::cout << name << " barks!\n";
+    }
+
+    // Along with constructors, C++ provides destructors.
+    // These are called when an object is deleted or falls out of scope.
+    // This enables powerful paradigms such as RAII
+    // (see below)
+    // The destructor should be virtual if a class is to be derived from;
+    // if it is not virtual, then the derived class' destructor will
+    // not be called if the object is destroyed through a base-class reference
+    // or pointer.
+    virtual ~Dog();
+
+}; // A semicolon must follow the class definition.
+
+// Inheritance:
+
+// This class inherits everything public and protected from the Dog class
+// as well as private but may not directly access private members/methods
+// without a public or protected method for doing so
+class OwnedDog : public Dog {
+
+public:
+    void setOwner(const std::string &dogsOwner);
+
+    // Override the behavior of the print function for all OwnedDogs.
+    // See http://en.wikipedia.org/wiki/Polymorphism_(computer_science)#Subtyping
+    // for a more general introduction if you're unfamiliar with
+    // subtype polymorphism.
+    // The override keyword is optional but makes sure you are actually
+    // overriding the method in a base case.
+    void print() const override;
+
+private:
+    std::string owner;
+};
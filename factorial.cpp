@@ -0,0 +1,5 @@
+#include "factorial.hpp"
+
+unsigned int Factorial(unsigned int number) {
+    return number <= 1 ? number : Factorial(number - 1) * number;
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+unsigned int Factorial(unsigned int number);
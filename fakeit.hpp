@@ -354,6 +354,11 @@ namespace fakeit {
             virtual bool matches(ActualInvocation<arglist...> &actualInvocation) = 0;
 
             virtual std::string format() const = 0;
+
+            // For a matcher of exactly one set of arguments: the hash of those, so stubs can be looked up by it
+            virtual bool exactArgumentsHash(size_t &) const {
+                return false;
+            }
         };
 
         ActualInvocation(unsigned int ordinal, MethodInfo &method, const typename fakeit::production_arg<arglist>::type... args) :
@@ -400,7 +405,10 @@ namespace fakeit {
 
 
 
+#include <algorithm>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace fakeit {
 
@@ -411,18 +419,66 @@ namespace fakeit {
 	};
 
     struct ActualInvocationsSource {
-        virtual void getActualInvocations(std::unordered_set<fakeit::Invocation *> &into) const = 0;
+        // Appends them in the order they were made (by ordinal)
+        virtual void getActualInvocations(std::vector<fakeit::Invocation *> &into) const = 0;
 
         virtual ~ActualInvocationsSource() NO_THROWS { }
     };
 
+    // Appends the invocations of logs that are each in invocation order, in invocation order, with a
+    // k-way merge. An invocation in several of them (a mock that's involved twice) is appended once.
+    inline void mergeInInvocationOrder(const std::vector<std::vector<fakeit::Invocation *>> &logs,
+                                       std::vector<fakeit::Invocation *> &into) {
+        typedef std::vector<fakeit::Invocation *>::const_iterator Position;
+        std::vector<std::pair<Position, Position>> heads;
+        size_t total = 0;
+        for (auto &log : logs) {
+            if (!log.empty())
+                heads.emplace_back(log.begin(), log.end());
+            total += log.size();
+        }
+        into.reserve(into.size() + total);
+        if (heads.size() == 1) {
+            into.insert(into.end(), heads[0].first, heads[0].second);
+            return;
+        }
+
+        auto later = [](const std::pair<Position, Position> &a, const std::pair<Position, Position> &b) {
+            return (*a.first)->getOrdinal() > (*b.first)->getOrdinal();
+        };
+        std::make_heap(heads.begin(), heads.end(), later);
+        fakeit::Invocation *last = nullptr;
+        while (!heads.empty()) {
+            std::pop_heap(heads.begin(), heads.end(), later);
+            auto &head = heads.back();
+            if (*head.first != last)
+                into.push_back(last = *head.first);
+            if (++head.first == head.second)
+                heads.pop_back();
+            else
+                std::push_heap(heads.begin(), heads.end(), later);
+        }
+    }
+
+    inline void mergeInInvocationOrder(const std::vector<ActualInvocationsSource *> &sources,
+                                       std::vector<fakeit::Invocation *> &into) {
+        if (sources.size() == 1) {
+            sources[0]->getActualInvocations(into);
+            return;
+        }
+        std::vector<std::vector<fakeit::Invocation *>> logs(sources.size());
+        for (size_t i = 0; i < sources.size(); ++i)
+            sources[i]->getActualInvocations(logs[i]);
+        mergeInInvocationOrder(logs, into);
+    }
+
     struct InvocationsSourceProxy : public ActualInvocationsSource {
 
         InvocationsSourceProxy(ActualInvocationsSource *inner) :
                 _inner(inner) {
         }
 
-        void getActualInvocations(std::unordered_set<fakeit::Invocation *> &into) const override {
+        void getActualInvocations(std::vector<fakeit::Invocation *> &into) const override {
             _inner->getActualInvocations(into);
         }
 
@@ -435,12 +491,12 @@ namespace fakeit {
         UnverifiedInvocationsSource(InvocationsSourceProxy decorated) : _decorated(decorated) {
         }
 
-        void getActualInvocations(std::unordered_set<fakeit::Invocation *> &into) const override {
-            std::unordered_set<fakeit::Invocation *> all;
+        void getActualInvocations(std::vector<fakeit::Invocation *> &into) const override {
+            std::vector<fakeit::Invocation *> all;
             _decorated.getActualInvocations(all);
             for (fakeit::Invocation *i : all) {
                 if (!i->isVerified()) {
-                    into.insert(i);
+                    into.push_back(i);
                 }
             }
         }
@@ -454,11 +510,9 @@ namespace fakeit {
         AggregateInvocationsSource(std::vector<ActualInvocationsSource *> &sources) : _sources(sources) {
         }
 
-        void getActualInvocations(std::unordered_set<fakeit::Invocation *> &into) const override {
-            std::unordered_set<fakeit::Invocation *> tmp;
-            for (ActualInvocationsSource *source : _sources) {
-                source->getActualInvocations(tmp);
-            }
+        void getActualInvocations(std::vector<fakeit::Invocation *> &into) const override {
+            std::vector<fakeit::Invocation *> tmp;
+            mergeInInvocationOrder(_sources, tmp);
             filter(tmp, into);
         }
 
@@ -470,10 +524,10 @@ namespace fakeit {
     private:
         std::vector<ActualInvocationsSource *> _sources;
 
-        void filter(std::unordered_set<Invocation *> &source, std::unordered_set<Invocation *> &target) const {
+        void filter(std::vector<Invocation *> &source, std::vector<Invocation *> &target) const {
             for (Invocation *i:source) {
                 if (shouldInclude(i)) {
-                    target.insert(i);
+                    target.push_back(i);
                 }
             }
         }
@@ -1220,9 +1274,10 @@ namespace fakeit {
                 Catch::ResultWas::OfType resultWas = Catch::ResultWas::OfType::ExpressionFailed ){
             Catch::AssertionHandler catchAssertionHandler( vetificationType, sourceLineInfo, failingExpression, Catch::ResultDisposition::Normal );
             INTERNAL_CATCH_TRY { \
+                CATCH_INTERNAL_START_WARNINGS_SUPPRESSION \
                 CATCH_INTERNAL_SUPPRESS_PARENTHESES_WARNINGS \
                 catchAssertionHandler.handleMessage(resultWas, fomattedMessage); \
-                CATCH_INTERNAL_UNSUPPRESS_PARENTHESES_WARNINGS \
+                CATCH_INTERNAL_STOP_WARNINGS_SUPPRESSION \
             } INTERNAL_CATCH_CATCH(catchAssertionHandler) { \
                 INTERNAL_CATCH_REACT(catchAssertionHandler) \
             }
@@ -6011,8 +6066,7 @@ namespace fakeit {
 
         Destructible *getInvocatoinHandlerPtrById(unsigned int id) override {
             unsigned int offset = getOffset(id);
-            std::shared_ptr<Destructible> ptr = _methodMocks[offset];
-            return ptr.get();
+            return _methodMocks[offset].get();
         }
 
     };
@@ -6770,6 +6824,72 @@ namespace fakeit {
         const std::vector<Destructible *> _matchers;
     };
 
+    template<typename T, typename = void>
+    struct is_hashable : std::false_type {
+    };
+
+    template<typename T>
+    struct is_hashable<T, decltype(void(std::hash<T>()(std::declval<const T &>())))> : std::true_type {
+    };
+
+    template<bool ...>
+    struct bool_pack {
+    };
+
+    template<bool ... bs>
+    struct all_true : std::is_same<bool_pack<true, bs...>, bool_pack<bs..., true>> {
+    };
+
+    template<typename ... arglist>
+    using are_hashable = all_true<is_hashable<typename naked_type<arglist>::type>::value...>;
+
+    // Combines the arguments' std::hashes, the same for a tuple of the arguments as for one of references to them
+    struct ArgumentsHasher {
+        template<typename A>
+        void operator()(size_t, const A &arg) {
+            hash ^= std::hash<typename naked_type<A>::type>()(arg) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        }
+
+        size_t hash = 0;
+    };
+
+    template<typename TupleType>
+    size_t hashArguments(TupleType &arguments, std::true_type) {
+        ArgumentsHasher hasher;
+        TupleDispatcher::for_each(arguments, hasher);
+        return hasher.hash;
+    }
+
+    template<typename TupleType>
+    size_t hashArguments(TupleType &, std::false_type) {
+        return 0;
+    }
+
+    // Using() with a value for every argument, each of a type std::hash knows: compares the arguments
+    // as a whole instead of one matcher at a time, and can be looked up by their hash
+    template<typename ... arglist>
+    struct ExactArgumentsInvocationMatcher : public ArgumentsMatcherInvocationMatcher<arglist...> {
+
+        ExactArgumentsInvocationMatcher(const std::vector<Destructible *> &matchers,
+                                        const std::tuple<typename naked_type<arglist>::type...> &expected)
+                : ArgumentsMatcherInvocationMatcher<arglist...>(matchers), _expected(expected),
+                  _hash(hashArguments(_expected, std::true_type())) {
+        }
+
+        virtual bool matches(ActualInvocation<arglist...> &invocation) override {
+            return invocation.getActualMatcher() == this || invocation.getActualArguments() == _expected;
+        }
+
+        virtual bool exactArgumentsHash(size_t &hash) const override {
+            hash = _hash;
+            return true;
+        }
+
+    private:
+        std::tuple<typename naked_type<arglist>::type...> _expected;
+        size_t _hash;
+    };
+
 
 
 
@@ -6852,9 +6972,314 @@ namespace fakeit {
 
 }
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+
 namespace fakeit {
 
+    // Where a RecordedMethodBody records its invocations: blocks of them, each twice the size of the
+    // one before, so recording one only allocates when a block fills up. Invocations stay where they
+    // are once recorded.
+    //
+    // Any number of threads can record at once: each takes the next slot with one atomic increment,
+    // the thread that first needs a block installs it with a compare-and-swap, and a slot is only
+    // visited once the thread that took it has published it. One that's withdrawn instead is destroyed
+    // straight away, and its slot given back if nothing's been recorded after it. clear() destroys them
+    // all and keeps the first block for the next ones; it, and visiting them, is for when nothing's
+    // being recorded.
+    template<typename T>
+    class InvocationArena {
+
+        enum : unsigned char {
+            Empty, Recorded, Published
+        };
+
+        struct Slot {
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+            std::atomic<unsigned char> state;
+
+            T *get() {
+                return reinterpret_cast<T *>(&storage);
+            }
+        };
+
+        static constexpr size_t firstBlockCapacity = 16;
+        static constexpr size_t maxBlocks = 32;
+
+        std::atomic<Slot *> _blocks[maxBlocks];
+        std::atomic<size_t> _size{0};
+
+        static size_t blockCapacity(size_t block) {
+            return firstBlockCapacity << block;
+        }
+
+        // Which block slot i is in, and where in it
+        static size_t blockOf(size_t i, size_t &offset) {
+            size_t j = i + firstBlockCapacity;
+            size_t block = 0;
+#if defined(__GNUC__)
+            block = static_cast<size_t>(63 - __builtin_clzll(j)) - 4;
+#else
+            while (blockCapacity(block + 1) <= j)
+                ++block;
+#endif
+            offset = j - blockCapacity(block);
+            return block;
+        }
+
+        Slot *block(size_t b) {
+            Slot *slots = _blocks[b].load(std::memory_order_acquire);
+            if (slots)
+                return slots;
+            Slot *created = new Slot[blockCapacity(b)];
+            for (size_t i = 0; i < blockCapacity(b); ++i)
+                created[i].state.store(Empty, std::memory_order_relaxed);
+            if (_blocks[b].compare_exchange_strong(slots, created, std::memory_order_acq_rel))
+                return created;
+            delete[] created;
+            return slots;
+        }
+
+        static Slot &slotOf(T &t) {
+            return *reinterpret_cast<Slot *>(&t);
+        }
+
+        size_t indexOf(Slot &slot) const {
+            for (size_t b = 0, first = 0; b < maxBlocks; first += blockCapacity(b), ++b) {
+                Slot *slots = _blocks[b].load(std::memory_order_acquire);
+                if (slots && &slot >= slots && &slot < slots + blockCapacity(b))
+                    return first + static_cast<size_t>(&slot - slots);
+            }
+            return 0;
+        }
+
+    public:
+
+        InvocationArena() {
+            for (auto &b : _blocks)
+                b.store(nullptr, std::memory_order_relaxed);
+        }
+
+        InvocationArena(const InvocationArena &) = delete;
+
+        InvocationArena &operator=(const InvocationArena &) = delete;
+
+        ~InvocationArena() {
+            clear();
+            delete[] _blocks[0].load(std::memory_order_relaxed);
+        }
+
+        // Not visited until it's published, or ever if it's withdrawn instead
+        template<typename ... Args>
+        T &emplace_back(Args &&... args) {
+            size_t offset;
+            size_t b = blockOf(_size.fetch_add(1, std::memory_order_relaxed), offset);
+            Slot &slot = block(b)[offset];
+            T *t = new(slot.get()) T(std::forward<Args>(args)...);
+            slot.state.store(Recorded, std::memory_order_relaxed);
+            return *t;
+        }
+
+        void publish(T &t) {
+            slotOf(t).state.store(Published, std::memory_order_release);
+        }
+
+        void withdraw(T &t) {
+            Slot &slot = slotOf(t);
+            size_t i = indexOf(slot);
+            t.~T();
+            slot.state.store(Empty, std::memory_order_release);
+            size_t next = i + 1;
+            _size.compare_exchange_strong(next, i, std::memory_order_acq_rel);
+        }
 
+        void clear() {
+            size_t size = _size.load(std::memory_order_acquire);
+            for (size_t b = 0, first = 0; b < maxBlocks && first < size; first += blockCapacity(b), ++b) {
+                Slot *slots = _blocks[b].load(std::memory_order_acquire);
+                for (size_t i = 0; slots && i < blockCapacity(b) && first + i < size; ++i) {
+                    if (slots[i].state.load(std::memory_order_relaxed) != Empty)
+                        slots[i].get()->~T();
+                    slots[i].state.store(Empty, std::memory_order_relaxed);
+                }
+                if (b > 0)
+                    delete[] _blocks[b].exchange(nullptr, std::memory_order_relaxed);
+            }
+            _size.store(0, std::memory_order_release);
+        }
+
+        template<typename F>
+        void forEach(F &&f) const {
+            size_t size = _size.load(std::memory_order_acquire);
+            for (size_t b = 0, first = 0; b < maxBlocks && first < size; first += blockCapacity(b), ++b) {
+                Slot *slots = _blocks[b].load(std::memory_order_acquire);
+                for (size_t i = 0; slots && i < blockCapacity(b) && first + i < size; ++i)
+                    if (slots[i].state.load(std::memory_order_acquire) == Published)
+                        f(*slots[i].get());
+            }
+        }
+    };
+
+    // Sorts what's been appended to into from first on by ordinal, if it isn't already
+    inline void restoreInvocationOrder(std::vector<Invocation *> &into, size_t first) {
+        auto byOrdinal = [](Invocation *a, Invocation *b) { return a->getOrdinal() < b->getOrdinal(); };
+        if (!std::is_sorted(into.begin() + first, into.end(), byOrdinal))
+            std::sort(into.begin() + first, into.end(), byOrdinal);
+    }
+
+    // The stubs of a RecordedMethodBody that aren't for exact arguments, newest last. A reader's table
+    // never changes under it: adding a stub writes past the end of what readers look at, and a full
+    // table is copied into one twice its size, which is published in its place. Replaced tables are
+    // kept until clear(), so stubs can be added, from one thread, while others are looking them up.
+    template<typename T>
+    class StubTable {
+
+        struct Table {
+            explicit Table(size_t capacity) : entries(new T *[capacity]), capacity(capacity) {
+            }
+
+            std::unique_ptr<T *[]> entries;
+            size_t capacity;
+            std::atomic<size_t> size{0};
+        };
+
+        std::vector<std::unique_ptr<Table>> _tables;
+        std::atomic<Table *> _published{nullptr};
+
+    public:
+
+        void push_back(T *t) {
+            Table *table = _tables.empty() ? nullptr : _tables.back().get();
+            size_t size = table ? table->size.load(std::memory_order_relaxed) : 0;
+            if (table && size < table->capacity) {
+                table->entries[size] = t;
+                table->size.store(size + 1, std::memory_order_release);
+                return;
+            }
+            std::unique_ptr<Table> grown{new Table(table ? table->capacity * 2 : 4)};
+            if (table)
+                std::copy(table->entries.get(), table->entries.get() + size, grown->entries.get());
+            grown->entries[size] = t;
+            grown->size.store(size + 1, std::memory_order_relaxed);
+            _published.store(grown.get(), std::memory_order_release);
+            _tables.push_back(std::move(grown));
+        }
+
+        // Only when nothing's looking them up
+        void clear() {
+            _published.store(nullptr, std::memory_order_release);
+            _tables.clear();
+        }
+
+        // As the thread adding them sees it
+        size_t size() const {
+            return _tables.empty() ? 0 : _tables.back()->size.load(std::memory_order_relaxed);
+        }
+
+        // The newest one that matches, of those from the first'th on
+        template<typename F>
+        T *findLast(F &&matches, size_t first = 0) const {
+            Table *table = _published.load(std::memory_order_acquire);
+            if (!table)
+                return nullptr;
+            for (size_t i = table->size.load(std::memory_order_acquire); i > first; --i) {
+                if (matches(*table->entries[i - 1]))
+                    return table->entries[i - 1];
+            }
+            return nullptr;
+        }
+    };
+
+    // The stubs of a RecordedMethodBody that are for exact arguments, by the hash of those: a flat
+    // table probed linearly, kept at most half full. A slot's stub is published after its hash, and a
+    // full table is replaced like a StubTable's, so stubs can be added, from one thread, while others
+    // are looking them up. Stubs for the same arguments aren't merged: the newest one is found.
+    template<typename T>
+    class ExactStubTable {
+
+        struct Slot {
+            size_t hash;
+            size_t order;
+            std::atomic<T *> stub{nullptr};
+        };
+
+        struct Table {
+            explicit Table(size_t capacity) : slots(new Slot[capacity]), mask(capacity - 1) {
+            }
+
+            std::unique_ptr<Slot[]> slots;
+            size_t mask;
+            size_t size = 0;
+
+            void put(size_t hash, size_t order, T *stub) {
+                size_t i = hash & mask;
+                while (slots[i].stub.load(std::memory_order_relaxed))
+                    i = (i + 1) & mask;
+                slots[i].hash = hash;
+                slots[i].order = order;
+                slots[i].stub.store(stub, std::memory_order_release);
+                ++size;
+            }
+        };
+
+        std::vector<std::unique_ptr<Table>> _tables;
+        std::atomic<Table *> _published{nullptr};
+        size_t _added = 0;
+
+    public:
+
+        bool empty() const {
+            return _published.load(std::memory_order_relaxed) == nullptr;
+        }
+
+        void put(size_t hash, T *stub) {
+            Table *table = _tables.empty() ? nullptr : _tables.back().get();
+            if (table && (table->size + 1) * 2 <= table->mask + 1) {
+                table->put(hash, _added++, stub);
+                return;
+            }
+            std::unique_ptr<Table> grown{new Table(table ? (table->mask + 1) * 2 : 8)};
+            for (size_t i = 0; table && i <= table->mask; ++i) {
+                if (T *moved = table->slots[i].stub.load(std::memory_order_relaxed))
+                    grown->put(table->slots[i].hash, table->slots[i].order, moved);
+            }
+            grown->put(hash, _added++, stub);
+            _published.store(grown.get(), std::memory_order_release);
+            _tables.push_back(std::move(grown));
+        }
+
+        // Only when nothing's looking them up
+        void clear() {
+            _published.store(nullptr, std::memory_order_release);
+            _tables.clear();
+            _added = 0;
+        }
+
+        // The newest one with this hash that matches
+        template<typename F>
+        T *find(size_t hash, F &&matches) const {
+            Table *table = _published.load(std::memory_order_acquire);
+            if (!table)
+                return nullptr;
+            T *found = nullptr;
+            size_t order = 0;
+            for (size_t i = hash & table->mask;; i = (i + 1) & table->mask) {
+                T *stub = table->slots[i].stub.load(std::memory_order_acquire);
+                if (!stub)
+                    return found;
+                if (table->slots[i].hash == hash && (!found || table->slots[i].order > order) && matches(*stub)) {
+                    found = stub;
+                    order = table->slots[i].order;
+                }
+            }
+        }
+    };
+
+    // Stubbed, cleared and reset from one thread, and called from any number of threads at once,
+    // while it's being stubbed too
     template<typename R, typename ... arglist>
     class RecordedMethodBody : public MethodInvocationHandler<R, arglist...>, public ActualInvocationsSource, public ActualInvocationsContainer {
 
@@ -6867,57 +7292,45 @@ namespace fakeit {
                     _matcher{matcher}, _invocationHandler{invocationHandler} {
             }
 
+            // For one of exact arguments: how many of the others there were when it was added
+            size_t olderStubs = 0;
+
             virtual R handleMethodInvocation(ArgumentsTuple<arglist...> & args) override
             {
-                Destructible &destructable = *_invocationHandler;
-                ActualInvocationHandler<R, arglist...> &invocationHandler = dynamic_cast<ActualInvocationHandler<R, arglist...> &>(destructable);
-                return invocationHandler.handleMethodInvocation(args);
+                return _invocationHandler->handleMethodInvocation(args);
             }
 
             typename ActualInvocation<arglist...>::Matcher &getMatcher() const {
-                Destructible &destructable = *_matcher;
-                typename ActualInvocation<arglist...>::Matcher &matcher = dynamic_cast<typename ActualInvocation<arglist...>::Matcher &>(destructable);
-                return matcher;
+                return *_matcher;
             }
 
         private:
-            std::shared_ptr<Destructible> _matcher;
-            std::shared_ptr<Destructible> _invocationHandler;
+            std::unique_ptr<typename ActualInvocation<arglist...>::Matcher> _matcher;
+            std::unique_ptr<ActualInvocationHandler<R, arglist...>> _invocationHandler;
         };
 
 
         FakeitContext &_fakeit;
         MethodInfo _method;
 
-        std::vector<std::shared_ptr<Destructible>> _invocationHandlers;
-        std::vector<std::shared_ptr<Destructible>> _actualInvocations;
-
-        MatchedInvocationHandler *buildMatchedInvocationHandler(
-                typename ActualInvocation<arglist...>::Matcher *invocationMatcher,
-                ActualInvocationHandler<R, arglist...> *invocationHandler) {
-            return new MatchedInvocationHandler(invocationMatcher, invocationHandler);
-        }
+        std::vector<std::unique_ptr<MatchedInvocationHandler>> _stubs;
+        StubTable<MatchedInvocationHandler> _invocationHandlers;
+        ExactStubTable<MatchedInvocationHandler> _exactInvocationHandlers;
+        InvocationArena<ActualInvocation<arglist...>> _actualInvocations;
 
+        // The newest stub that matches: the one for exactly these arguments, one hash lookup away,
+        // unless one of the others added after it matches them too
         MatchedInvocationHandler *getInvocationHandlerForActualArgs(ActualInvocation<arglist...> &invocation) {
-            for (auto i = _invocationHandlers.rbegin(); i != _invocationHandlers.rend(); ++i) {
-                std::shared_ptr<Destructible> curr = *i;
-                Destructible &destructable = *curr;
-                MatchedInvocationHandler &im = asMatchedInvocationHandler(destructable);
-                if (im.getMatcher().matches(invocation)) {
-                    return &im;
-                }
+            auto matches = [&invocation](MatchedInvocationHandler &im) {
+                return im.getMatcher().matches(invocation);
+            };
+            MatchedInvocationHandler *exact = nullptr;
+            if (!_exactInvocationHandlers.empty()) {
+                size_t hash = hashArguments(invocation.getActualArguments(), are_hashable<arglist...>());
+                exact = _exactInvocationHandlers.find(hash, matches);
             }
-            return nullptr;
-        }
-
-        MatchedInvocationHandler &asMatchedInvocationHandler(Destructible &destructable) {
-            MatchedInvocationHandler &im = dynamic_cast<MatchedInvocationHandler &>(destructable);
-            return im;
-        }
-
-        ActualInvocation<arglist...> &asActualInvocation(Destructible &destructable) const {
-            ActualInvocation<arglist...> &invocation = dynamic_cast<ActualInvocation<arglist...> &>(destructable);
-            return invocation;
+            MatchedInvocationHandler *newer = _invocationHandlers.findLast(matches, exact ? exact->olderStubs : 0);
+            return newer ? newer : exact;
         }
 
     public:
@@ -6939,13 +7352,20 @@ namespace fakeit {
 
         void addMethodInvocationHandler(typename ActualInvocation<arglist...>::Matcher *matcher,
             ActualInvocationHandler<R, arglist...> *invocationHandler) {
-            ActualInvocationHandler<R, arglist...> *mock = buildMatchedInvocationHandler(matcher, invocationHandler);
-            std::shared_ptr<Destructible> destructable{mock};
-            _invocationHandlers.push_back(destructable);
+            _stubs.emplace_back(new MatchedInvocationHandler(matcher, invocationHandler));
+            size_t hash;
+            if (matcher->exactArgumentsHash(hash)) {
+                _stubs.back()->olderStubs = _invocationHandlers.size();
+                _exactInvocationHandlers.put(hash, _stubs.back().get());
+            } else {
+                _invocationHandlers.push_back(_stubs.back().get());
+            }
         }
 
         void reset() {
             _invocationHandlers.clear();
+            _exactInvocationHandlers.clear();
+            _stubs.clear();
             _actualInvocations.clear();
         }
 
@@ -6956,16 +7376,25 @@ namespace fakeit {
         R handleMethodInvocation(const typename fakeit::production_arg<arglist>::type... args) override {
             unsigned int ordinal = Invocation::nextInvocationOrdinal();
             MethodInfo &method = this->getMethod();
-            auto actualInvocation = new ActualInvocation<arglist...>(ordinal, method, std::forward<const typename fakeit::production_arg<arglist>::type>(args)...);
-
-
-            std::shared_ptr<Destructible> actualInvocationDtor{actualInvocation};
+            // Recorded up front, and published once it's known which stub it matched, or withdrawn
+            // however the call ends if none did
+            auto actualInvocation = &_actualInvocations.emplace_back(ordinal, method, std::forward<const typename fakeit::production_arg<arglist>::type>(args)...);
+            struct Withdraw {
+                InvocationArena<ActualInvocation<arglist...>> &arena;
+                ActualInvocation<arglist...> *invocation;
+
+                ~Withdraw() {
+                    if (invocation)
+                        arena.withdraw(*invocation);
+                }
+            } withdraw{_actualInvocations, actualInvocation};
 
             auto invocationHandler = getInvocationHandlerForActualArgs(*actualInvocation);
             if (invocationHandler) {
                 auto &matcher = invocationHandler->getMatcher();
                 actualInvocation->setActualMatcher(&matcher);
-                _actualInvocations.push_back(actualInvocationDtor);
+                _actualInvocations.publish(*actualInvocation);
+                withdraw.invocation = nullptr;
                 try {
                     return invocationHandler->handleMethodInvocation(actualInvocation->getActualArguments());
                 } catch (NoMoreRecordedActionException &) {
@@ -6980,17 +7409,17 @@ namespace fakeit {
         }
 
         void scanActualInvocations(const std::function<void(ActualInvocation<arglist...> &)> &scanner) {
-            for (auto destructablePtr : _actualInvocations) {
-                ActualInvocation<arglist...> &invocation = asActualInvocation(*destructablePtr);
-                scanner(invocation);
-            }
+            _actualInvocations.forEach(scanner);
         }
 
-        void getActualInvocations(std::unordered_set<Invocation *> &into) const override {
-            for (auto destructablePtr : _actualInvocations) {
-                Invocation &invocation = asActualInvocation(*destructablePtr);
-                into.insert(&invocation);
-            }
+        // In the order they're recorded in, which is invocation order unless they're recorded from
+        // several threads at once
+        void getActualInvocations(std::vector<Invocation *> &into) const override {
+            size_t first = into.size();
+            _actualInvocations.forEach([&into](ActualInvocation<arglist...> &invocation) {
+                into.push_back(&invocation);
+            });
+            restoreInvocationOrder(into, first);
         }
 
         void setMethodDetails(const std::string &mockName, const std::string &methodName) {
@@ -7093,7 +7522,9 @@ namespace fakeit {
     struct Action : Destructible {
         virtual R invoke(const ArgumentsTuple<arglist...> &) = 0;
 
-        virtual bool isDone() = 0;
+        // Takes one of the invocations it's for, if there are any left. Calls on several threads
+        // can take them at once
+        virtual bool take() = 0;
     };
 
     template<typename R, typename ... arglist>
@@ -7109,17 +7540,23 @@ namespace fakeit {
         }
 
         virtual R invoke(const ArgumentsTuple<arglist...> & args) override {
-            times--;
             return TupleDispatcher::invoke<R, arglist...>(f, args);
         }
 
-        virtual bool isDone() override {
-            return times == 0;
+        // Never runs out if it's for no invocations to begin with
+        virtual bool take() override {
+            if (forever)
+                return true;
+            long left = times.load(std::memory_order_relaxed);
+            while (left > 0 && !times.compare_exchange_weak(left, left - 1, std::memory_order_relaxed)) {
+            }
+            return left > 0;
         }
 
     private:
         std::function<R(typename fakeit::test_arg<arglist>::type...)> f;
-        long times;
+        std::atomic<long> times;
+        const bool forever = times <= 0;
     };
 
     template<typename R, typename ... arglist>
@@ -7135,8 +7572,8 @@ namespace fakeit {
             return TupleDispatcher::invoke<R, arglist...>(f, args);
         }
 
-        virtual bool isDone() override {
-            return false;
+        virtual bool take() override {
+            return true;
         }
 
     private:
@@ -7151,8 +7588,8 @@ namespace fakeit {
             return DefaultValue<R>::value();
         }
 
-        virtual bool isDone() override {
-            return false;
+        virtual bool take() override {
+            return true;
         }
     };
 
@@ -7167,8 +7604,8 @@ namespace fakeit {
             return TupleDispatcher::invoke<R, arglist...>(_delegate, args);
         }
 
-        virtual bool isDone() override {
-            return false;
+        virtual bool take() override {
+            return true;
         }
 
     private:
@@ -7397,6 +7834,9 @@ namespace fakeit {
 namespace fakeit {
 
 
+    // The actions of a stub, in the order they're used up. Calls on several threads can use them
+    // up at once: each takes an invocation from the first action that has any left, and moves the
+    // sequence on past the ones that don't. Actions are appended from one thread.
     template<typename R, typename ... arglist>
     struct ActionSequence : ActualInvocationHandler<R,arglist...> {
 
@@ -7410,48 +7850,40 @@ namespace fakeit {
 
         virtual R handleMethodInvocation(ArgumentsTuple<arglist...> & args) override
         {
-            std::shared_ptr<Destructible> destructablePtr = _recordedActions.front();
-            Destructible &destructable = *destructablePtr;
-            Action<R, arglist...> &action = dynamic_cast<Action<R, arglist...> &>(destructable);
-            std::function<void()> finallyClause = [&]() -> void {
-                if (action.isDone())
-                    _recordedActions.erase(_recordedActions.begin());
-            };
-            Finally onExit(finallyClause);
-            return action.invoke(args);
+            Node *node = _current.load(std::memory_order_acquire);
+            while (node) {
+                if (node->action && node->action->take())
+                    return node->action->invoke(args);
+                Node *next = node->next.load(std::memory_order_acquire);
+                if (next)
+                    _current.compare_exchange_strong(node, next, std::memory_order_acq_rel);
+                node = next;
+            }
+            throw NoMoreRecordedActionException();
         }
 
     private:
 
-        struct NoMoreRecordedAction : Action<R, arglist...> {
-
-
-
-
-
-
-
-            virtual R invoke(const ArgumentsTuple<arglist...> &) override {
-                throw NoMoreRecordedActionException();
-            }
-
-            virtual bool isDone() override {
-                return false;
-            }
+        struct Node {
+            std::unique_ptr<Action<R, arglist...>> action;
+            std::atomic<Node *> next{nullptr};
         };
 
         void append(Action<R, arglist...> *action) {
-            std::shared_ptr<Destructible> destructable{action};
-            _recordedActions.insert(_recordedActions.end() - 1, destructable);
+            _nodes.emplace_back(new Node);
+            _nodes.back()->action.reset(action);
+            _nodes[_nodes.size() - 2]->next.store(_nodes.back().get(), std::memory_order_release);
         }
 
+        // Starting from an empty node the first action's appended after
         void clear() {
-            _recordedActions.clear();
-            auto actionPtr = std::shared_ptr<Destructible> {new NoMoreRecordedAction()};
-            _recordedActions.push_back(actionPtr);
+            _nodes.clear();
+            _nodes.emplace_back(new Node);
+            _current.store(_nodes.front().get(), std::memory_order_release);
         }
 
-        std::vector<std::shared_ptr<Destructible>> _recordedActions;
+        std::vector<std::unique_ptr<Node>> _nodes;
+        std::atomic<Node *> _current;
     };
 
 }
@@ -7670,13 +8102,15 @@ namespace fakeit {
                 return s;
             }
 
-            void getActualInvocations(std::unordered_set<Invocation *> &into) const {
+            void getActualInvocations(std::vector<Invocation *> &into) const {
+                size_t first = into.size();
                 auto scanner = [&](ActualInvocation<arglist...> &a) {
                     if (_invocationMatcher->matches(a)) {
-                        into.insert(&a);
+                        into.push_back(&a);
                     }
                 };
                 getStubbingContext().scanActualInvocations(scanner);
+                restoreInvocationOrder(into, first);
             }
 
 
@@ -7758,7 +8192,7 @@ namespace fakeit {
         }
 
 
-        void getActualInvocations(std::unordered_set<Invocation *> &into) const override {
+        void getActualInvocations(std::vector<Invocation *> &into) const override {
             _impl->getActualInvocations(into);
         }
 
@@ -7804,11 +8238,36 @@ namespace fakeit {
             MatchersCollector<0, arglist...> c(matchers);
             c.CollectMatchers(matcherCreator...);
 
-            MethodMockingContext<R, arglist...>::setMatchingCriteria(matchers);
+            setMatchingCriteria(matchers, std::integral_constant<bool,
+                    all_true<is_argument_value<matcherCreators, arglist>::value...>::value &&
+                    are_hashable<arglist...>::value>(), matcherCreator...);
         }
 
     private:
 
+        // A value to compare the argument to, rather than a matcher of it
+        template<typename Head, typename Arg>
+        struct is_argument_value : std::integral_constant<bool,
+                std::is_constructible<typename naked_type<Arg>::type, Head>::value &&
+                !std::is_base_of<TypedMatcherCreator<typename naked_type<Arg>::type>, Head>::value &&
+                !std::is_same<AnyMatcher, Head>::value> {
+        };
+
+        template<class ...matcherCreators>
+        void setMatchingCriteria(const std::vector<Destructible *> &matchers, std::true_type,
+                                 const matcherCreators &... values) {
+            typename ActualInvocation<arglist...>::Matcher *matcher{
+                    new ExactArgumentsInvocationMatcher<arglist...>(
+                            matchers, std::tuple<typename naked_type<arglist>::type...>(values...))};
+            _impl->setInvocationMatcher(matcher);
+        }
+
+        template<class ...matcherCreators>
+        void setMatchingCriteria(const std::vector<Destructible *> &matchers, std::false_type,
+                                 const matcherCreators &...) {
+            MethodMockingContext<R, arglist...>::setMatchingCriteria(matchers);
+        }
+
         typename std::function<R(arglist&...)> getOriginalMethod() override {
             return _impl->getOriginalMethod();
         }
@@ -7982,12 +8441,10 @@ namespace fakeit {
         }
 
 
-        void getActualInvocations(std::unordered_set<Invocation *> &into) const override {
+        void getActualInvocations(std::vector<Invocation *> &into) const override {
             std::vector<ActualInvocationsSource *> vec;
             _proxy.getMethodMocks(vec);
-            for (ActualInvocationsSource *s : vec) {
-                s->getActualInvocations(into);
-            }
+            mergeInInvocationOrder(vec, into);
         }
 
 	    void initDataMembersIfOwner()
@@ -8401,7 +8858,7 @@ namespace fakeit {
             return impl.stubDtor();
         }
 
-        void getActualInvocations(std::unordered_set<Invocation *> &into) const override {
+        void getActualInvocations(std::vector<Invocation *> &into) const override {
             impl.getActualInvocations(into);
         }
 
@@ -8590,31 +9047,17 @@ namespace fakeit {
 
     struct InvocationUtils {
 
-        static void sortByInvocationOrder(std::unordered_set<Invocation *> &ivocations,
-                                          std::vector<Invocation *> &result) {
-            auto comparator = [](Invocation *a, Invocation *b) -> bool {
-                return a->getOrdinal() < b->getOrdinal();
-            };
-            std::set<Invocation *, bool (*)(Invocation *a, Invocation *b)> sortedIvocations(comparator);
-            for (auto i : ivocations)
-                sortedIvocations.insert(i);
-
-            for (auto i : sortedIvocations)
-                result.push_back(i);
-        }
-
-        static void collectActualInvocations(std::unordered_set<Invocation *> &actualInvocations,
+        // In invocation order
+        static void collectActualInvocations(std::vector<Invocation *> &actualInvocations,
                                              std::vector<ActualInvocationsSource *> &invocationSources) {
-            for (auto source : invocationSources) {
-                source->getActualInvocations(actualInvocations);
-            }
+            mergeInInvocationOrder(invocationSources, actualInvocations);
         }
 
-        static void selectNonVerifiedInvocations(std::unordered_set<Invocation *> &actualInvocations,
-                                                 std::unordered_set<Invocation *> &into) {
+        static void selectNonVerifiedInvocations(std::vector<Invocation *> &actualInvocations,
+                                                 std::vector<Invocation *> &into) {
             for (auto invocation : actualInvocations) {
                 if (!invocation->isVerified()) {
-                    into.insert(invocation);
+                    into.push_back(invocation);
                 }
             }
         }
@@ -8657,6 +9100,9 @@ namespace fakeit {
 
 #include <memory>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <unordered_set>
 
@@ -8674,44 +9120,103 @@ namespace fakeit {
     private:
         static void getActualInvocationSequence(InvocationsSourceProxy &involvedMocks,
                                                 std::vector<Invocation *> &actualSequence) {
-            std::unordered_set<Invocation *> actualInvocations;
-            collectActualInvocations(involvedMocks, actualInvocations);
-            InvocationUtils::sortByInvocationOrder(actualInvocations, actualSequence);
-        }
+            involvedMocks.getActualInvocations(actualSequence);
+        }
+
+        // One Sequence of the pattern, whose matchers have to match consecutive invocations, as a
+        // shift-and automaton: bit j of the state is set while the last j + 1 invocations match its
+        // first j + 1 matchers. Each invocation is given at most once to each distinct matcher (and
+        // only to those at a position the state can move to), however long the sequence is, e.g.
+        // Method(mock, foo) * 1000.
+        struct SequenceAutomaton {
+            unsigned int length;
+
+            explicit SequenceAutomaton(const Sequence &sequence) {
+                std::vector<Invocation::Matcher *> expectedSequence;
+                sequence.getExpectedSequence(expectedSequence);
+                length = static_cast<unsigned int>(expectedSequence.size());
+                _state.assign((length + 63) / 64, 0);
+                _accepted.assign(_state.size(), 0);
+                for (unsigned int j = 0; j < length; j++) {
+                    auto distinct = std::find(_matchers.begin(), _matchers.end(), expectedSequence[j]) - _matchers.begin();
+                    if (distinct == static_cast<std::ptrdiff_t>(_matchers.size())) {
+                        _matchers.push_back(expectedSequence[j]);
+                        _positions.emplace_back(_state.size(), 0);
+                    }
+                    _positions[distinct][j / 64] |= uint64_t{1} << (j % 64);
+                }
+            }
 
-        static int countMatches(std::vector<Sequence *> &pattern, std::vector<Invocation *> &actualSequence,
-                                std::vector<Invocation *> &matchedInvocations) {
-            int end = -1;
-            int count = 0;
-            int startSearchIndex = 0;
-            while (findNextMatch(pattern, actualSequence, startSearchIndex, end, matchedInvocations)) {
-                count++;
-                startSearchIndex = end;
+            void reset() {
+                std::fill(_state.begin(), _state.end(), 0);
             }
-            return count;
-        }
 
-        static void collectActualInvocations(InvocationsSourceProxy &involvedMocks,
-                                             std::unordered_set<Invocation *> &actualInvocations) {
-            involvedMocks.getActualInvocations(actualInvocations);
-        }
+            // Whether the sequence ends with this invocation
+            bool step(Invocation &invocation) {
+                // The positions this invocation can extend a match to
+                uint64_t carry = 1;
+                for (size_t w = 0; w < _state.size(); w++) {
+                    uint64_t next = _state[w] >> 63;
+                    _state[w] = (_state[w] << 1) | carry;
+                    carry = next;
+                }
+                std::fill(_accepted.begin(), _accepted.end(), 0);
+                for (size_t k = 0; k < _matchers.size(); k++) {
+                    if (isWanted(_positions[k]) && _matchers[k]->matches(invocation)) {
+                        for (size_t w = 0; w < _accepted.size(); w++)
+                            _accepted[w] |= _positions[k][w];
+                    }
+                }
+                for (size_t w = 0; w < _state.size(); w++)
+                    _state[w] &= _accepted[w];
+                return (_state[(length - 1) / 64] >> ((length - 1) % 64)) & 1;
+            }
+
+        private:
+            bool isWanted(const std::vector<uint64_t> &positions) const {
+                for (size_t w = 0; w < _state.size(); w++) {
+                    if (positions[w] & _state[w])
+                        return true;
+                }
+                return false;
+            }
+
+            std::vector<Invocation::Matcher *> _matchers;
+            std::vector<std::vector<uint64_t>> _positions;
+            std::vector<uint64_t> _state;
+            std::vector<uint64_t> _accepted;
+        };
 
-        static bool findNextMatch(std::vector<Sequence *> &pattern, std::vector<Invocation *> &actualSequence,
-                                  int startSearchIndex, int &end,
-                                  std::vector<Invocation *> &matchedInvocations) {
+        // Finds the pattern's sequences one after the other, each at the earliest invocation after the
+        // previous one, in a single pass. Invocations of sequences found after the last full match
+        // count as matched too, as they always have.
+        static int countMatches(std::vector<Sequence *> &pattern, std::vector<Invocation *> &actualSequence,
+                                std::vector<Invocation *> &matchedInvocations) {
+            if (pattern.empty())
+                return 0;
+            std::vector<SequenceAutomaton> automata;
             for (auto sequence : pattern) {
-                int index = findNextMatch(sequence, actualSequence, startSearchIndex);
-                if (index == -1) {
-                    return false;
+                automata.emplace_back(*sequence);
+            }
+
+            int count = 0;
+            size_t current = 0;
+            for (size_t i = 0; i < actualSequence.size(); i++) {
+                SequenceAutomaton &automaton = automata[current];
+                if (!automaton.step(*actualSequence[i])) {
+                    continue;
+                }
+                collectMatchedInvocations(actualSequence, matchedInvocations, static_cast<int>(i + 1 - automaton.length),
+                                          static_cast<int>(automaton.length));
+                automaton.reset();
+                if (++current == automata.size()) {
+                    count++;
+                    current = 0;
                 }
-                collectMatchedInvocations(actualSequence, matchedInvocations, index, sequence->size());
-                startSearchIndex = index + sequence->size();
             }
-            end = startSearchIndex;
-            return true;
+            return count;
         }
 
-
         static void collectMatchedInvocations(std::vector<Invocation *> &actualSequence,
                                               std::vector<Invocation *> &matchedInvocations, int start,
                                               int length) {
@@ -8721,29 +9226,6 @@ namespace fakeit {
             }
         }
 
-
-        static bool isMatch(std::vector<Invocation *> &actualSequence,
-                            std::vector<Invocation::Matcher *> &expectedSequence, int start) {
-            bool found = true;
-            for (unsigned int j = 0; found && j < expectedSequence.size(); j++) {
-                Invocation *actual = actualSequence[start + j];
-                Invocation::Matcher *expected = expectedSequence[j];
-                found = found && expected->matches(*actual);
-            }
-            return found;
-        }
-
-        static int findNextMatch(Sequence *&pattern, std::vector<Invocation *> &actualSequence, int startSearchIndex) {
-            std::vector<Invocation::Matcher *> expectedSequence;
-            pattern->getExpectedSequence(expectedSequence);
-            for (int i = startSearchIndex; i < ((int) actualSequence.size() - (int) expectedSequence.size() + 1); i++) {
-                if (isMatch(actualSequence, expectedSequence, i)) {
-                    return i;
-                }
-            }
-            return -1;
-        }
-
     };
 }
 
@@ -9140,20 +9622,14 @@ namespace fakeit {
                     return;
                 _isVerified = true;
 
-                std::unordered_set<Invocation *> actualInvocations;
+                std::vector<Invocation *> actualInvocations;
                 InvocationUtils::collectActualInvocations(actualInvocations, _mocks);
 
-                std::unordered_set<Invocation *> nonVerifiedInvocations;
+                std::vector<Invocation *> nonVerifiedInvocations;
                 InvocationUtils::selectNonVerifiedInvocations(actualInvocations, nonVerifiedInvocations);
 
                 if (nonVerifiedInvocations.size() > 0) {
-                    std::vector<Invocation *> sortedNonVerifiedInvocations;
-                    InvocationUtils::sortByInvocationOrder(nonVerifiedInvocations, sortedNonVerifiedInvocations);
-
-                    std::vector<Invocation *> sortedActualInvocations;
-                    InvocationUtils::sortByInvocationOrder(actualInvocations, sortedActualInvocations);
-
-                    NoMoreInvocationsVerificationEvent evt(sortedActualInvocations, sortedNonVerifiedInvocations);
+                    NoMoreInvocationsVerificationEvent evt(actualInvocations, nonVerifiedInvocations);
                     evt.setFileInfo(_file, _line, _callingMethod);
                     return verificationErrorHandler.handle(evt);
                 }
@@ -1,12 +1,23 @@
-#define CATCH_CONFIG_MAIN  // This tells Catch to provide a main() -- only do this in one cpp file
-
 #include "catch.hpp"
 
-unsigned int Factorial(unsigned int number) {
-    return number <= 1 ? number : Factorial(number - 1) * number;
-}
+#include "factorial.hpp"
+#include "add.hpp"
+#include "box.hpp"
+#include "point.hpp"
+#include "catch-extensions/allocations.hpp"
+#include "catch-extensions/parallel-generate.hpp"
+#include "catch-extensions/range-assertions.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdlib>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
-TEST_CASE("Factorial works", "[factorial]") {
+TEST_CASE("Factorial works", "[factorial][parallel]") {
     REQUIRE(Factorial(0) == 0);
     REQUIRE(Factorial(1) == 1);
     REQUIRE(Factorial(2) == 2);
@@ -16,15 +27,15 @@ TEST_CASE("Factorial works", "[factorial]") {
     REQUIRE(Factorial(10) == 3628800);
 }
 
-TEST_CASE("Addition works", "[addition]") {
+TEST_CASE("Addition works", "[addition][parallel]") {
     REQUIRE(1 + 1 == 2);
 }
 
-TEST_CASE("Subtraction works", "[subtraction]") {
+TEST_CASE("Subtraction works", "[subtraction][parallel]") {
     REQUIRE(1 - 1 == 0);
 }
 
-TEST_CASE("Division works", "[division]") {
+TEST_CASE("Division works", "[division][parallel]") {
     REQUIRE(2 / 2 == 1);
     REQUIRE(3 / 2 == 1);
     REQUIRE(3 % 2 == 1);
@@ -32,24 +43,19 @@ TEST_CASE("Division works", "[division]") {
     REQUIRE(5 % 2 == 1);
 }
 
-// Playing with templates
-
-template<typename T>
-T add(T a, T b) {
-    return a + b;
-}
+// Playing with templates (see add.hpp)
 
-TEST_CASE("Generic Add Ints") {
+TEST_CASE("Generic Add Ints", "[parallel]") {
     REQUIRE(1 + 2 == 3);
     REQUIRE(add(1, 2) == 3);
 }
 
-TEST_CASE("Generic Add Doubles") {
+TEST_CASE("Generic Add Doubles", "[parallel]") {
     REQUIRE(1.5 + 1.5 == 3.0);
     REQUIRE(add(1.5, 1.5) == 3.0);
 }
 
-TEST_CASE("Generic Add Strings") {
+TEST_CASE("Generic Add Strings", "[parallel]") {
     REQUIRE(std::string("ab") + std::string("xy") == "abxy");
     REQUIRE(add(std::string("ab"), std::string("xy")) == "abxy");
 }
@@ -107,4 +113,399 @@ TEST_CASE("BDD-style?") {
             }
         }
     }
-}
\ No newline at end of file
+}
+
+// Allocation budgets (see catch-extensions/allocations.hpp)
+
+TEST_CASE("Allocation budgets", "[allocations][parallel]") {
+    Point p(1, 2);
+    REQUIRE_ALLOCATIONS(== 0, p += Point(3, 4));
+    REQUIRE_ALLOCATIONS(== 0, p = p + Point(1, 1));
+
+    Box<int> box;
+    REQUIRE_ALLOCATIONS(== 0, box.insert(1));
+
+    std::vector<int> v;
+    REQUIRE_ALLOCATIONS(== 1, v.reserve(100));
+    REQUIRE_ALLOCATIONS(== 0, v.assign(100, 1));
+
+    SECTION("Reduce without copying every partial result") {
+        std::vector<std::string> words{"Programming", "in", "a", "functional", "style."};
+        auto join = [](const std::string &a, const std::string &b) { return a + ":" + b; };
+        auto joinCopies = [](std::string a, std::string b) { return a + ":" + b; };
+
+        auto byReference = extensions::countAllocations([&] { std::accumulate(words.begin(), words.end(), std::string(), join); });
+        auto byValue = extensions::countAllocations([&] { std::accumulate(words.begin(), words.end(), std::string(), joinCopies); });
+        REQUIRE(byReference.count < byValue.count);
+    }
+}
+
+// Range assertions (see catch-extensions/range-assertions.hpp)
+
+TEST_CASE("Range assertions", "[ranges][parallel]") {
+    std::vector<int> squares(100000);
+    for (std::size_t i = 0; i < squares.size(); ++i) {
+        squares[i] = static_cast<int>(i % 1000) * static_cast<int>(i % 1000);
+    }
+    REQUIRE_ALL_OF(squares, [](int square) { return square >= 0; });
+    CHECK_RANGE(std::vector<int>{1, 4, 9}, std::vector<int>{1, 4, 9});
+
+    SECTION("Failures show only the first mismatches") {
+        auto check = extensions::allOf(squares, [](int square) { return square % 2 == 0; });
+        REQUIRE(check.mismatches == squares.size() / 2);
+        REQUIRE(Catch::Detail::stringify(check) ==
+                "50000 of 100000 elements don't match: [1] 1, [3] 9, [5] 25, [7] 49, [9] 81, ...");
+    }
+
+    SECTION("and the sizes, if they differ") {
+        auto check = extensions::equalRanges(std::vector<int>{1, 4, 8}, std::vector<int>{1, 4, 9, 16});
+        REQUIRE(!check);
+        REQUIRE(Catch::Detail::stringify(check) == "sizes differ: 3 != 4, 1 of 3 elements don't match: [2] 8 != 9");
+    }
+}
+
+// Data-driven tests over a thread pool (see catch-extensions/parallel-generate.hpp)
+
+TEST_CASE("Generated values checked in parallel", "[generators][parallel]") {
+    GENERATE_PARALLEL(range(2u, 13u), [](unsigned n) {
+        REQUIRE(Factorial(n) == n * Factorial(n - 1));
+    });
+
+    GENERATE_PARALLEL(range(-10000, 10000), [](int i) {
+        CHECK(add(i, 1) == add(1, i));
+        CHECK(add(i, -i) == 0);
+    });
+
+    GENERATE_PARALLEL(map([](int i) { return Point(i, -i); }, range(0, 1000)), [](Point const &p) {
+        INFO("(" << p.x << ", " << p.y << ")");
+        Point q(1.5, 2.5);
+        REQUIRE(p + q - q == p);
+        REQUIRE_NOTHROW(p + q);
+    });
+}
+
+namespace {
+    // Stands in for the RunContext GENERATE_PARALLEL records on behalf of and replays into
+    class ReplayCapture : public Catch::IResultCapture {
+    public:
+        // A failed assertion
+        struct Result {
+            std::string text;
+            std::vector<std::string> messages;
+        };
+
+        std::vector<Result> results;
+        std::vector<Catch::MessageInfo> scoped;
+        std::size_t passed = 0;
+        // As the RunContext is after --abort's failures
+        bool aborting = false;
+
+        bool sectionStarted(Catch::SectionInfo const &, Catch::Counts &) override {
+            return false;
+        }
+
+        void sectionEnded(Catch::SectionEndInfo const &) override {}
+
+        void sectionEndedEarly(Catch::SectionEndInfo const &) override {}
+
+        auto acquireGeneratorTracker(Catch::SourceLineInfo const &) -> Catch::IGeneratorTracker & override {
+            throw std::logic_error("not a test case");
+        }
+
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+        void benchmarkPreparing(std::string const &) override {}
+
+        void benchmarkStarting(Catch::BenchmarkInfo const &) override {}
+
+        void benchmarkEnded(Catch::BenchmarkStats<> const &) override {}
+
+        void benchmarkFailed(std::string const &) override {}
+#endif
+
+        void pushScopedMessage(Catch::MessageInfo const &message) override {
+            scoped.push_back(message);
+        }
+
+        void popScopedMessage(Catch::MessageInfo const &message) override {
+            scoped.erase(std::remove(scoped.begin(), scoped.end(), message), scoped.end());
+        }
+
+        void emplaceUnscopedMessage(Catch::MessageBuilder const &) override {}
+
+        void handleFatalErrorCondition(Catch::StringRef) override {}
+
+        void handleExpr(Catch::AssertionInfo const &info, Catch::ITransientExpression const &expr,
+                        Catch::AssertionReaction &reaction) override {
+            std::ostringstream expansion;
+            expr.streamReconstructedExpression(expansion);
+            record(expr.getResult() != Catch::isFalseTest(info.resultDisposition), expansion.str(), info, reaction);
+        }
+
+        void handleMessage(Catch::AssertionInfo const &info, Catch::ResultWas::OfType resultType,
+                           Catch::StringRef const &message, Catch::AssertionReaction &reaction) override {
+            record(Catch::isOk(resultType), static_cast<std::string>(message), info, reaction);
+        }
+
+        void handleUnexpectedExceptionNotThrown(Catch::AssertionInfo const &info,
+                                                Catch::AssertionReaction &reaction) override {
+            record(false, {}, info, reaction);
+        }
+
+        void handleUnexpectedInflightException(Catch::AssertionInfo const &info, std::string const &message,
+                                               Catch::AssertionReaction &reaction) override {
+            record(false, message, info, reaction);
+        }
+
+        void handleIncomplete(Catch::AssertionInfo const &) override {}
+
+        void handleNonExpr(Catch::AssertionInfo const &info, Catch::ResultWas::OfType resultType,
+                           Catch::AssertionReaction &reaction) override {
+            record(Catch::isOk(resultType), {}, info, reaction);
+        }
+
+        bool lastAssertionPassed() override {
+            return true;
+        }
+
+        void assertionPassed() override {
+            ++passed;
+        }
+
+        std::string getCurrentTestName() const override {
+            return "GENERATE_PARALLEL";
+        }
+
+        const Catch::AssertionResult *getLastResult() const override {
+            return nullptr;
+        }
+
+        void exceptionEarlyReported() override {}
+
+    private:
+        // Passing assertions, which are only replayed with -s, count as passed either way
+        void record(bool ok, std::string text, Catch::AssertionInfo const &info, Catch::AssertionReaction &reaction) {
+            if (ok) {
+                ++passed;
+                return;
+            }
+            std::vector<std::string> messages;
+            for (auto &message : scoped) {
+                messages.push_back(message.message);
+            }
+            results.push_back({std::move(text), std::move(messages)});
+            // As RunContext::populateReaction does
+            reaction.shouldThrow = aborting || (info.resultDisposition & Catch::ResultDisposition::Normal);
+        }
+    };
+
+    // Makes capture this thread's result capture while it exists, as GENERATE_PARALLEL's threads do
+    class ResultCaptureScope {
+    public:
+        explicit ResultCaptureScope(Catch::IResultCapture &capture)
+                : context(Catch::getCurrentMutableContext()), previous(context.getResultCapture()) {
+            context.setResultCapture(&capture);
+        }
+
+        ~ResultCaptureScope() {
+            context.setResultCapture(previous);
+        }
+
+        ResultCaptureScope(ResultCaptureScope const &) = delete;
+
+        ResultCaptureScope &operator=(ResultCaptureScope const &) = delete;
+
+    private:
+        Catch::IMutableContext &context;
+        Catch::IResultCapture *previous;
+    };
+}
+
+TEST_CASE("GENERATE_PARALLEL records each value's assertions and replays them in order", "[generators]") {
+    using extensions::detail::RecordedAssertion;
+    using Strings = std::vector<std::string>;
+
+    ReplayCapture real;
+    Catch::AssertionInfo generatorInfo{"GENERATE_PARALLEL"_catch_sr, CATCH_INTERNAL_LINEINFO, "range(0, 6)",
+                                       Catch::ResultDisposition::Normal};
+    // Values 0 and 3 fail the REQUIRE, 4 and 5 the CHECK
+    auto body = [](int i) {
+        INFO("half " << i / 2);
+        CAPTURE(i);
+        REQUIRE(i % 3 != 0);
+        CHECK(i < 4);
+    };
+
+    SECTION("Failing assertions are recorded with their value and messages, passing ones only counted") {
+        extensions::detail::RecordingCapture capture(real, generatorInfo, false);
+        {
+            ResultCaptureScope scope(capture);
+            for (int i = 0; i < 6; ++i) {
+                capture.run(static_cast<std::size_t>(i), body, i);
+            }
+        }
+
+        // A failing REQUIRE ends the body for its own value only
+        REQUIRE(capture.recorded.size() == 4);
+        REQUIRE(capture.passed == 6);
+        std::vector<std::size_t> values;
+        for (auto &assertion : capture.recorded) {
+            values.push_back(assertion.value);
+            REQUIRE(assertion.kind == RecordedAssertion::Kind::Expression);
+            REQUIRE(assertion.type == Catch::ResultWas::ExpressionFailed);
+            REQUIRE(assertion.isBinaryExpression);
+            REQUIRE_FALSE(assertion.result);
+        }
+        REQUIRE(values == std::vector<std::size_t>{0, 3, 4, 5});
+        REQUIRE(capture.recorded[0].text == "0 != 0");
+        REQUIRE(capture.recorded[0].info.macroName == "REQUIRE");
+        REQUIRE(capture.recorded[2].text == "4 < 4");
+        REQUIRE(capture.recorded[2].info.macroName == "CHECK");
+        REQUIRE(capture.recorded[1].messages.size() == 2);
+        REQUIRE(capture.recorded[1].messages[0].message == "half 1");
+        REQUIRE(capture.recorded[1].messages[1].message == "i := 3");
+        REQUIRE(real.results.empty());
+    }
+
+    SECTION("With -s, passing assertions are recorded too") {
+        extensions::detail::RecordingCapture capture(real, generatorInfo, true);
+        {
+            ResultCaptureScope scope(capture);
+            for (int i = 0; i < 6; ++i) {
+                capture.run(static_cast<std::size_t>(i), body, i);
+            }
+        }
+
+        REQUIRE(capture.recorded.size() == 10);
+        REQUIRE(capture.passed == 0);
+        std::vector<bool> oks;
+        for (auto &assertion : capture.recorded) {
+            oks.push_back(assertion.type == Catch::ResultWas::Ok);
+            REQUIRE(assertion.result == oks.back());
+            REQUIRE(assertion.messages.size() == 2);
+        }
+        REQUIRE(oks == std::vector<bool>{false, true, true, true, true, false, true, false, true, false});
+        REQUIRE(capture.recorded[1].value == 1);
+        REQUIRE(capture.recorded[1].text == "1 != 0");
+    }
+
+    SECTION("Failures are replayed in the order of the values, each with its value and messages") {
+        bool required = false;
+        {
+            ResultCaptureScope scope(real);
+            try {
+                GENERATE_PARALLEL(range(0, 6), body);
+            } catch (Catch::TestFailureException &) {
+                required = true;
+            }
+        }
+
+        // The test case only ends once every value's failures are reported
+        REQUIRE(required);
+        REQUIRE(real.results.size() == 4);
+        REQUIRE(real.passed == 6);
+        REQUIRE(real.results[0].text == "0 != 0");
+        REQUIRE(real.results[0].messages == Strings{"value 0 := 0", "half 0", "i := 0"});
+        REQUIRE(real.results[1].messages == Strings{"value 3 := 3", "half 1", "i := 3"});
+        REQUIRE(real.results[2].text == "4 < 4");
+        REQUIRE(real.results[2].messages == Strings{"value 4 := 4", "half 2", "i := 4"});
+        REQUIRE(real.results[3].messages == Strings{"value 5 := 5", "half 2", "i := 5"});
+        // Every message pushed for a replayed assertion was popped again
+        REQUIRE(real.scoped.empty());
+    }
+
+    SECTION("A failing CHECK ends the test case straight away once the run is aborting (--abort)") {
+        real.aborting = true;
+        bool aborted = false;
+        {
+            ResultCaptureScope scope(real);
+            try {
+                GENERATE_PARALLEL(range(0, 6), [](int i) {
+                    CHECK(i < 4);
+                });
+            } catch (Catch::TestFailureException &) {
+                aborted = true;
+            }
+        }
+
+        REQUIRE(aborted);
+        REQUIRE(real.results.size() == 1);
+        REQUIRE(real.results[0].text == "4 < 4");
+        REQUIRE(real.results[0].messages == Strings{"value 4 := 4"});
+    }
+}
+
+// A GENERATE's generator lives in its test case's trackers, which are destroyed when the test case ends
+
+namespace {
+    int liveGenerators = 0;
+
+    class CountedGenerator : public Catch::Generators::IGenerator<int> {
+    public:
+        CountedGenerator() {
+            ++liveGenerators;
+        }
+
+        ~CountedGenerator() override {
+            --liveGenerators;
+        }
+
+        int const &get() const override {
+            return value;
+        }
+
+        bool next() override {
+            return ++value < 3;
+        }
+
+    private:
+        int value = 0;
+    };
+
+    Catch::Generators::GeneratorWrapper<int> counted() {
+        return Catch::Generators::GeneratorWrapper<int>(std::unique_ptr<Catch::Generators::IGenerator<int>>(new CountedGenerator));
+    }
+
+    // Run through Catch::Detail::runTestCasesInIsolation, rather than registered, so that they run
+    // one after the other whatever runs the other test cases, and in whatever order
+    void countedValues() {
+        auto i = GENERATE(counted());
+        REQUIRE(i < 3);
+        REQUIRE(liveGenerators == 1);
+    }
+
+    void afterCountedValues() {
+        REQUIRE(liveGenerators == 0);
+    }
+}
+
+TEST_CASE("A GENERATE's generator is kept for its test case and destroyed when it ends", "[generators]") {
+    std::vector<Catch::TestCase> testCases{
+            Catch::makeTestCase(Catch::makeTestInvoker(&countedValues), "",
+                                Catch::NameAndTags("Counted values"), CATCH_INTERNAL_LINEINFO),
+            Catch::makeTestCase(Catch::makeTestInvoker(&afterCountedValues), "",
+                                Catch::NameAndTags("After counted values"), CATCH_INTERNAL_LINEINFO)
+    };
+    auto totals = Catch::Detail::runTestCasesInIsolation(testCases);
+    // One generator for the three values, which each pass both REQUIREs, and none left after them
+    REQUIRE(totals.assertions.passed == 7);
+    REQUIRE(totals.assertions.failed == 0);
+    REQUIRE(totals.testCases.passed == 2);
+    REQUIRE(liveGenerators == 0);
+}
+
+// Test cases that take their process down, for --fork (see catch-extensions/fork-session.hpp).
+// Hidden: without --fork, the first of them would end the run.
+
+TEST_CASE("A crash in a section", "[.][crash]") {
+    SECTION("segfaults") {
+        std::raise(SIGSEGV);
+    }
+}
+
+TEST_CASE("An exit half way", "[.][crash]") {
+    std::exit(3);
+}
+
+TEST_CASE("A test case after them", "[.][crash]") {
+    REQUIRE(Factorial(3) == 6);
+}
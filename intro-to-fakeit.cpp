@@ -1,6 +1,13 @@
+#include <atomic>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 #include "catch.hpp"
-//#include "fakeit.hpp"
+#include "fakeit.hpp"
+#include "catch-extensions/allocations.hpp"
+
+using namespace fakeit;
 
 struct SomeInterface {
     virtual int foo(int) = 0;
@@ -8,10 +15,176 @@ struct SomeInterface {
     virtual int bar(std::string) = 0;
 };
 
-//fakeit::Mock <SomeInterface> mock;
-//
-//When(Method(mock, foo)).Return(1);
-//
-//TEST_CASE("Mocking works", "[mock]") {
-//    REQUIRE(mock::foo == 1);
-//}
+TEST_CASE("Mocking works", "[mock]") {
+    Mock<SomeInterface> mock;
+    When(Method(mock, foo)).AlwaysReturn(1);
+    When(Method(mock, bar).Using("baz")).Return(2);
+
+    SomeInterface &i = mock.get();
+    REQUIRE(i.foo(0) == 1);
+    REQUIRE(i.bar("baz") == 2);
+
+    Verify(Method(mock, foo).Using(0), Method(mock, bar)).Once();
+    VerifyNoOtherInvocations(mock);
+}
+
+TEST_CASE("Mocks remember every invocation until they're cleared", "[mock]") {
+    Mock<SomeInterface> mock;
+    When(Method(mock, foo)).AlwaysDo([](int n) { return n * 2; });
+    When(Method(mock, bar)).AlwaysDo([](std::string s) { return static_cast<int>(s.size()); });
+    SomeInterface &i = mock.get();
+
+    for (int n = 0; n < 10000; ++n) {
+        REQUIRE(i.foo(n) == n * 2);
+    }
+    REQUIRE(i.bar(std::string(100, 'x')) == 100);
+    Verify(Method(mock, foo)).Exactly(10000);
+    Verify(Method(mock, foo).Using(9999)).Once();
+    Verify(Method(mock, bar).Using(std::string(100, 'x'))).Once();
+
+    SECTION("ClearInvocationHistory forgets them, but keeps the stubs") {
+        mock.ClearInvocationHistory();
+        Verify(Method(mock, foo)).Never();
+        REQUIRE(i.foo(21) == 42);
+        Verify(Method(mock, foo).Using(21)).Once();
+        VerifyNoOtherInvocations(mock);
+    }
+
+    SECTION("Reset forgets the stubs as well") {
+        mock.Reset();
+        Verify(Method(mock, foo)).Never();
+        When(Method(mock, foo)).Return(7);
+        REQUIRE(i.foo(0) == 7);
+        Verify(Method(mock, foo)).Once();
+    }
+}
+
+TEST_CASE("Verification sees invocations in the order they were made", "[mock]") {
+    Mock<SomeInterface> first;
+    Mock<SomeInterface> second;
+    When(Method(first, foo)).AlwaysReturn(0);
+    When(Method(first, bar)).AlwaysReturn(0);
+    When(Method(second, foo)).AlwaysReturn(0);
+
+    first.get().foo(1);
+    second.get().foo(2);
+    first.get().bar("a");
+    first.get().foo(3);
+
+    Verify(Method(first, foo).Using(1) + Method(first, bar) + Method(first, foo).Using(3)).Once();
+    Verify(Method(first, foo) + Method(second, foo) + Method(first, bar)).Once();
+    REQUIRE_FALSE(Verify(Method(first, bar) + Method(second, foo)));
+    VerifyNoOtherInvocations(first, second);
+}
+
+TEST_CASE("Long sequences are verified in one pass over the invocations", "[mock]") {
+    Mock<SomeInterface> mock;
+    When(Method(mock, foo)).AlwaysReturn(0);
+    When(Method(mock, bar)).AlwaysReturn(0);
+    SomeInterface &i = mock.get();
+    for (int n = 0; n < 10000; ++n) {
+        i.foo(n % 100);
+        if (n % 100 == 99) {
+            i.bar("end");
+        }
+    }
+
+    Verify(Method(mock, foo) * 100 + Method(mock, bar)).Exactly(100);
+    Verify(Method(mock, foo) * 101).Never();
+    Verify(Method(mock, foo).Using(98) + Method(mock, foo).Using(99), Method(mock, bar)).Exactly(100);
+    VerifyNoOtherInvocations(mock);
+}
+
+TEST_CASE("Mocks can be called from several threads at once", "[mock][threads]") {
+    Mock<SomeInterface> mock;
+    When(Method(mock, foo)).AlwaysDo([](int n) { return n * 2; });
+    When(Method(mock, bar)).Return(1000_Times(1)).AlwaysReturn(0);
+    SomeInterface &i = mock.get();
+
+    std::atomic<int> doubled{0};
+    std::atomic<int> ones{0};
+    std::atomic<int> restubbed{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int n = 0; n < 10000; ++n) {
+                doubled += i.foo(n) == n * 2;
+                if (n % 5 == 0) {
+                    ones += i.bar("");
+                }
+            }
+            // Until the stub added below, while these are running, is seen
+            while (i.foo(-1) != -1) {
+                std::this_thread::yield();
+            }
+            ++restubbed;
+        });
+    }
+    When(Method(mock, foo).Using(-1)).AlwaysReturn(-1);
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(doubled == 40000);
+    REQUIRE(ones == 1000);
+    REQUIRE(restubbed == 4);
+    Verify(Method(mock, foo).Using(9999)).Exactly(4);
+    Verify(Method(mock, bar)).Exactly(8000);
+    Verify(Method(mock, foo).Using(-1)).AtLeast(4);
+}
+
+TEST_CASE("Stubs for exact arguments are looked up by their hash", "[mock]") {
+    Mock<SomeInterface> mock;
+    When(Method(mock, foo)).AlwaysReturn(-1);
+    for (int n = 0; n < 1000; ++n) {
+        When(Method(mock, foo).Using(n)).AlwaysReturn(n * 10);
+    }
+    When(Method(mock, bar).Using("baz")).Return(1, 2);
+    When(Method(mock, bar).Using("baz")).Return(3);
+    SomeInterface &i = mock.get();
+
+    REQUIRE(i.foo(999) == 9990);
+    REQUIRE(i.foo(1000) == -1);
+    REQUIRE(i.bar("baz") == 3);
+
+    SECTION("The newest stub that matches still wins") {
+        When(Method(mock, foo).Using(Gt(500))).AlwaysReturn(0);
+        When(Method(mock, foo).Using(999)).AlwaysReturn(1);
+        REQUIRE(i.foo(999) == 1);
+        REQUIRE(i.foo(998) == 0);
+        REQUIRE(i.foo(500) == 5000);
+    }
+
+    SECTION("Reset forgets them") {
+        mock.Reset();
+        When(Method(mock, foo)).AlwaysReturn(7);
+        REQUIRE(i.foo(999) == 7);
+    }
+}
+
+TEST_CASE("Calls that no stub takes leave nothing recorded behind", "[mock]") {
+    Mock<SomeInterface> mock;
+    When(Method(mock, bar).Matching([](std::string &s) -> bool {
+        if (s.size() > 10) {
+            throw std::length_error(s);
+        }
+        return true;
+    })).AlwaysReturn(0);
+    SomeInterface &i = mock.get();
+    REQUIRE(i.bar("short") == 0);
+
+    auto liveBytes = extensions::detail::allocationCounters().liveBytes;
+    int thrown = 0;
+    for (int n = 0; n < 100; ++n) {
+        try {
+            i.bar(std::string(1000, 'x'));
+        } catch (std::length_error &) {
+            ++thrown;
+        }
+    }
+    // Before the REQUIREs, which some reporters keep
+    auto liveBytesAfter = extensions::detail::allocationCounters().liveBytes;
+    REQUIRE(thrown == 100);
+    REQUIRE(liveBytesAfter == liveBytes);
+    Verify(Method(mock, bar)).Once();
+}
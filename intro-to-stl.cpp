@@ -3,7 +3,7 @@
 #include <optional>
 
 
-TEST_CASE("stl::Strings") {
+TEST_CASE("stl::Strings", "[parallel]") {
     // https://en.cppreference.com/w/cpp/string
     std::string s = "hello";
     REQUIRE(s.length() == 5);
@@ -17,7 +17,7 @@ TEST_CASE("stl::Strings") {
     }
 }
 
-TEST_CASE("Optional") {
+TEST_CASE("Optional", "[parallel]") {
     auto i = std::optional<int>{1};
     REQUIRE(i.has_value() == true);
     REQUIRE(std::optional<std::string>{"Wow"}.has_value() == true);
@@ -26,7 +26,7 @@ TEST_CASE("Optional") {
     REQUIRE(!std::optional<char>{}.has_value());
 }
 
-TEST_CASE("HoFs") {
+TEST_CASE("HoFs", "[parallel]") {
     SECTION("std::transform") {
         auto xs = std::vector<int>{1, 2, 3, 4, 5};
         std::vector<int> ys = std::vector{1, 2, 3, 4, 5};
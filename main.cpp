@@ -1,6 +1,138 @@
-#include <iostream>
+// The only place Catch provides a main().
+// This TU is compiled once into its own object library and linked into the test executables,
+// so touching a test file no longer recompiles the whole of catch.hpp.
+#define CATCH_CONFIG_RUNNER
 
-//int main() {
-//    std::cout << "Hello, World!" << std::endl;
-//    return 0;
-//}
+#include "catch.hpp"
+
+#include "catch-extensions/async-output.hpp"
+#include "catch-extensions/options.hpp"
+#include "catch-extensions/output-capture.hpp"
+#include "catch-extensions/parallel-session.hpp"
+#include "tools/test-cache.hpp"
+#include "tools/test-history.hpp"
+
+#include <algorithm>
+#include <optional>
+
+int main(int argc, char *argv[]) {
+    Catch::Session session;
+
+    using namespace Catch::clara;
+    auto &options = extensions::options();
+    auto cli = session.cli()
+               | Opt(options.recordFile, "filename")
+               ["--record"]
+               ("write each test case's duration and result to a file, one JSON object per line")
+               | Opt(options.threads, "threads")
+               ["--threads"]
+               ("run the test cases tagged [parallel] on this many threads")
+               | Opt(options.historyFile, "filename")
+               ["--history"]
+               ("update the test history (durations and failures) in this file after the run")
+               | Opt(options.orderByHistory)
+               ["--order-by-history"]
+               ("run the test cases likeliest to fail first, then the shortest first (needs --history)")
+               | Opt(options.cacheFile, "filename")
+               ["--cache"]
+               ("skip the test cases that passed last time and whose sources haven't changed since")
+               | Opt(options.runAll)
+               ["--run-all"]
+               ("run every test case, even with --cache")
+               | Opt(options.allocations)
+               ["--allocations"]
+               ("report the allocations of every test case and section")
+               | Opt(options.perf)
+               ["--perf"]
+               ("report cycles, instructions, cache and branch misses of every test case and benchmark")
+               | Opt(options.asyncOutput)
+               ["--async-output"]
+               ("buffer stdout, and write it out from a background thread")
+               | Opt(options.capture)
+               ["--capture"]
+               ("capture the stdout and stderr of every test case, and only show those of failing ones")
+               | Opt(options.fork)
+               ["--fork"]
+               ("run every test case in a child process, so crashes and leftover state stay in there")
+               | Opt(options.forkBatch, "test cases")
+               ["--fork-batch"]
+               ("with --fork, run this many test cases in each child process (default 1)");
+    session.cli(cli);
+
+    int returnCode = session.applyCommandLine(argc, argv);
+    if (returnCode != 0) {
+        return returnCode;
+    }
+    if (options.orderByHistory && options.historyFile.empty()) {
+        Catch::cerr() << "--order-by-history needs a --history file" << std::endl;
+        return 1;
+    }
+    if ((options.allocations || options.perf) && options.threads > 0) {
+        // Both are counted per thread, and reported on the main thread
+        Catch::cerr() << "--allocations and --perf don't work with --threads" << std::endl;
+        return 1;
+    }
+    if (options.asyncOutput && options.threads > 0) {
+        // Its buffer is only for the main thread to write to
+        Catch::cerr() << "--async-output doesn't work with --threads" << std::endl;
+        return 1;
+    }
+    if (options.capture && (options.threads > 0 || options.asyncOutput)) {
+        // It redirects the whole process's stdout and stderr
+        Catch::cerr() << "--capture doesn't work with --threads or --async-output" << std::endl;
+        return 1;
+    }
+    if (options.fork && (options.threads > 0 || options.asyncOutput || options.allocations || options.perf)) {
+        // Forking with other threads running is asking for trouble, and the counters are per process
+        Catch::cerr() << "--fork doesn't work with --threads, --async-output, --allocations or --perf" << std::endl;
+        return 1;
+    }
+#if defined(CATCH_CONFIG_ENABLE_BENCHMARKING)
+    if (options.fork) {
+        Catch::cerr() << "--fork doesn't report benchmarks" << std::endl;
+        return 1;
+    }
+#endif
+    if (options.fork && options.forkBatch == 0) {
+        Catch::cerr() << "--fork-batch must be at least 1" << std::endl;
+        return 1;
+    }
+    if (options.perf) {
+        auto &reporter = session.configData().reporterName;
+        if (reporter != "console" && reporter != "xml") {
+            Catch::cerr() << "--perf only works with the console and xml reporters" << std::endl;
+            return 1;
+        }
+        reporter = "perf-" + reporter;
+    }
+    // Before the run, as that's when Catch's reporters pick up std::cout's buffer (both replace it)
+    std::optional<extensions::AsyncOutput> asyncOutput;
+    if (options.asyncOutput) {
+        asyncOutput.emplace();
+    }
+    std::optional<extensions::OutputCapture> outputCapture;
+    if (options.capture) {
+        outputCapture.emplace();
+    }
+    if (!options.cacheFile.empty() || options.orderByHistory || options.threads > 0 || options.fork) {
+        auto testCache = options.runAll ? cache::Cache{} : cache::load(options.cacheFile);
+        auto testHistory = options.orderByHistory ? history::load(options.historyFile) : history::History{};
+        return extensions::runParallel(session, options.threads, [&](std::vector<Catch::TestCase const *> &tests) {
+            if (!testCache.empty()) {
+                cache::SourceHasher hasher;
+                auto end = std::remove_if(tests.begin(), tests.end(), [&](Catch::TestCase const *test) {
+                    return cache::isUpToDate(testCache, test->name, hasher.hash(test->lineInfo.file));
+                });
+                if (end != tests.end()) {
+                    Catch::cout() << "Skipping " << (tests.end() - end) << " test cases that passed and haven't changed"
+                                  << " since (--run-all runs them)" << std::endl;
+                }
+                tests.erase(end, tests.end());
+            }
+            if (options.orderByHistory) {
+                history::sortByHistory(tests, testHistory, [](Catch::TestCase const *test) { return test->name; });
+            }
+        }, options.fork ? options.forkBatch : 0);
+    }
+    return session.run();
+}
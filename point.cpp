@@ -0,0 +1,32 @@
+#include "point.hpp"
+
+Point Point::operator+(const Point &rhs) const {
+    // Create a new point that is the sum of this one and rhs.
+    return {x + rhs.x, y + rhs.y}; // another way of saying `Point(x + rhs.x, y + rhs.y)`
+}
+
+Point Point::operator-(const Point &rhs) const {
+    return Point(x - rhs.x, y - rhs.y);
+}
+
+// It's good practice to return a reference to the leftmost variable of
+// an assignment. `(a += b) == c` will work this way.
+Point &Point::operator+=(const Point &rhs) {
+    x += rhs.x;
+    y += rhs.y;
+
+    // `this` is a pointer to the object, on which a method is called.
+    return *this;
+}
+
+Point &Point::operator-=(const Point &rhs) {
+    x -= rhs.x;
+    y -= rhs.y;
+
+    return *this;
+}
+
+bool Point::operator==(const Point &rhs) const {
+    return x == rhs.x &&
+           y == rhs.y;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+class Point {
+public:
+    // Member variables can be given default values in this manner.
+    double x = 0;
+    double y = 0;
+
+    // Define a default constructor which does nothing
+    // but initialize the Point to the default value (0, 0)
+    Point(double a, double b) :
+            x(a),
+            y(b) { /* Do nothing except initialize the values */ };
+
+    // Overload the + operator
+    Point operator+(const Point &rhs) const;
+
+    // Overload the += operator
+    Point &operator+=(const Point &rhs);
+
+    // Overload the - operator
+    Point operator-(const Point &rhs) const;
+
+    // Overload the -= operator
+    Point &operator-=(const Point &rhs);
+
+    // Overload the == operator
+    bool operator==(const Point &rhs) const;
+};
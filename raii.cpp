@@ -0,0 +1,106 @@
+#include "raii.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+bool doSomethingWithAFile(const FILE *fh) {
+    return true;
+}
+
+bool doSomethingElseWithIt(const FILE *fh) {
+    return true;
+}
+
+// To understand how this is useful,
+// consider a function that uses a C file handle
+void doSomethingWithAFile(const char *filename) {
+    // To begin with, assume nothing can fail
+    FILE *fh = fopen(filename, "r"); // Open the file in read mode.
+
+    doSomethingWithAFile(fh);
+    doSomethingElseWithIt(fh);
+
+    fclose(fh); // Close the file handle
+}
+
+// Unfortunately, things are quickly complicated by error handling.
+// Suppose fopen can fail, and that doSomethingWithTheFile and
+// doSomethingElseWithIt return error codes if they fail.
+// (Exceptions are the preferred way of handling failure,
+//  but some programmers, especially those with a C background,
+//  disagree on the utility of exceptions).
+// We now have to check each call for failure and close the file handle
+// if a problem occurred.
+bool doSomethingWithAFile2(const char *filename) {
+    FILE *fh = fopen(filename, "r"); // Open the file in read mode
+    if (fh == nullptr) { // The returned pointer is null on failure
+        return false; // report that failure to the caller
+    }
+
+    // Assume each function returns false if it failed
+    if (!doSomethingWithAFile(fh)) {
+        fclose(fh); // close the file handle so it doesn't leak
+        return false; // propagate the error
+    }
+    if (!doSomethingElseWithIt(fh)) {
+        fclose(fh); // close the file handle so it doesn't leak
+        return false; // propagate the error
+    }
+
+    fclose(fh); // close the file handle so it doesn't leak
+    return true; // indicate success
+}
+
+// C programmers often clean this up a little bit using goto:
+bool doSomethingWithAFile3(const char *filename) {
+    FILE *fh = fopen(filename, "r");
+    if (fh == nullptr) {
+        return false;
+    }
+
+    if (!doSomethingWithAFile(fh)) {
+        goto failure;
+    }
+    if (!doSomethingElseWithIt(fh)) {
+        goto failure;
+    }
+
+    fclose(fh);
+    return true;
+
+    failure:
+    std::cout << "lol I'm in a goto tag thingy" << std::endl;
+    fclose(fh);
+    return false;
+}
+
+// If the functions indicate errors using exceptions,
+// things are a little cleaner, but still sub-optimal.
+void doSomethingWithAFile4(const char *filename) {
+    FILE *fh = fopen(filename, "r");
+    if (fh == nullptr) {
+        throw std::runtime_error("Could not open the file.");
+    }
+    try {
+        doSomethingWithAFile(fh);
+        doSomethingElseWithIt(fh);
+    } catch (...) {
+        fclose(fh);
+        throw;
+    }
+
+    fclose(fh);
+}
+
+// Compare this to the use of C++'s file stream class (fstream)
+// fstream uses its destructor to close the file.
+// Recall from above that destructors are automatically called
+// whenever an object falls out of scope.
+void doSomethingWithAFile5(const char *filename) {
+    // ifstream is short for input file stream
+    std::ifstream fh(filename); // Open the file
+
+    // doSomethingWithAFile(fh);
+    // doSomethingElseWithIt(fh);
+} // The file is automatically closed here by the destructor
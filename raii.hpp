@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdio>
+
+bool doSomethingWithAFile(const FILE *fh);
+
+bool doSomethingElseWithIt(const FILE *fh);
+
+// Assume nothing can fail
+void doSomethingWithAFile(const char *filename);
+
+// Check each call for failure and close the file handle if a problem occurred
+bool doSomethingWithAFile2(const char *filename);
+
+// Same as above, cleaned up a little bit using goto
+bool doSomethingWithAFile3(const char *filename);
+
+// Errors are reported using exceptions
+void doSomethingWithAFile4(const char *filename);
+
+// RAII: std::ifstream closes the file in its destructor
+void doSomethingWithAFile5(const char *filename);
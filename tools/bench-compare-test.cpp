@@ -0,0 +1,65 @@
+#include "catch.hpp"
+
+#include "bench-compare.hpp"
+
+namespace {
+    bench::Result result(const std::string &name, double mean, double lower, double upper) {
+        bench::Result r;
+        r.name = name;
+        r.mean = mean;
+        r.lowerBound = lower;
+        r.upperBound = upper;
+        return r;
+    }
+}
+
+TEST_CASE("JSON parsing", "[json][parallel]") {
+    auto value = json::parse(R"({"a": [1, 2.5, -3e2], "b": {"c": "d\"e\n"}, "t": true, "n": null})");
+
+    REQUIRE(value["a"].array.size() == 3);
+    REQUIRE(value["a"].array[1].number == 2.5);
+    REQUIRE(value["a"].array[2].number == -300);
+    REQUIRE(value["b"]["c"].string == "d\"e\n");
+    REQUIRE(value["t"].boolean);
+    REQUIRE(value["n"].type == json::Value::Type::Null);
+    REQUIRE_FALSE(value.has("missing"));
+    REQUIRE_THROWS(value["missing"]);
+
+    REQUIRE_THROWS(json::parse("{\"a\": }"));
+    REQUIRE_THROWS(json::parse("[1, 2"));
+    REQUIRE(json::parse("\"" + json::escape("tab\there \x01") + "\"").string == "tab\there \x01");
+}
+
+TEST_CASE("Benchmark comparison", "[bench-compare][parallel]") {
+    auto baseline = result("Map", 100, 95, 105);
+
+    SECTION("Overlapping confidence intervals are noise") {
+        REQUIRE(bench::judge(baseline, result("Map", 110, 104, 116), 0.05) == bench::Verdict::Unchanged);
+    }
+
+    SECTION("A disjoint, slower interval is a regression") {
+        REQUIRE(bench::judge(baseline, result("Map", 120, 110, 130), 0.05) == bench::Verdict::Regressed);
+    }
+
+    SECTION("Differences within the tolerance don't count, however certain") {
+        REQUIRE(bench::judge(baseline, result("Map", 107, 106, 108), 0.10) == bench::Verdict::Unchanged);
+    }
+
+    SECTION("A disjoint, faster interval is an improvement") {
+        REQUIRE(bench::judge(baseline, result("Map", 80, 75, 85), 0.05) == bench::Verdict::Improved);
+    }
+
+    SECTION("Added and removed benchmarks") {
+        bench::Run before{0.95, {baseline, result("Filter", 10, 9, 11)}};
+        bench::Run after{0.95, {baseline, result("Reduce", 10, 9, 11)}};
+
+        auto comparisons = bench::compare(before, after, 0.05);
+        REQUIRE(comparisons.size() == 3);
+        REQUIRE(comparisons[0].verdict == bench::Verdict::Unchanged);
+        REQUIRE(comparisons[0].ratio() == 1);
+        REQUIRE(comparisons[1].name == "Reduce");
+        REQUIRE(comparisons[1].verdict == bench::Verdict::Added);
+        REQUIRE(comparisons[2].name == "Filter");
+        REQUIRE(comparisons[2].verdict == bench::Verdict::Removed);
+    }
+}
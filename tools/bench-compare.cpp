@@ -0,0 +1,76 @@
+// Fails (exit code 1) if any benchmark in the current run regressed against the baseline.
+//
+// usage: bench-compare <baseline.json> <current.json> [--tolerance 0.05]
+
+#include "bench-compare.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+    bench::Run load(const char *path) {
+        std::ifstream in(path);
+        if (!in) {
+            throw std::runtime_error(std::string("could not open ") + path);
+        }
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        return bench::readRun(json::parse(buffer.str()));
+    }
+
+    const char *describe(bench::Verdict verdict) {
+        switch (verdict) {
+            case bench::Verdict::Unchanged: return "";
+            case bench::Verdict::Improved: return "improved";
+            case bench::Verdict::Regressed: return "REGRESSED";
+            case bench::Verdict::Added: return "new";
+            case bench::Verdict::Removed: return "removed";
+        }
+        return "";
+    }
+}
+
+int main(int argc, char **argv) {
+    double tolerance = 0.05;
+    char *end = nullptr;
+    if (argc == 5) {
+        tolerance = std::strtod(argv[4], &end);
+    }
+    if ((argc != 3 && !(argc == 5 && std::string(argv[3]) == "--tolerance")) ||
+        (argc == 5 && (end == argv[4] || *end != '\0' || !(tolerance >= 0)))) {
+        std::cerr << "usage: " << argv[0] << " <baseline.json> <current.json> [--tolerance 0.05]\n";
+        return 2;
+    }
+
+    try {
+        auto baseline = load(argv[1]);
+        auto current = load(argv[2]);
+        if (baseline.confidenceInterval != current.confidenceInterval) {
+            std::cerr << "warning: the baseline used a " << baseline.confidenceInterval
+                      << " confidence interval, the current run " << current.confidenceInterval << "\n";
+        }
+
+        int regressions = 0;
+        std::printf("%-50s %14s %14s %8s\n", "benchmark", "baseline (ns)", "current (ns)", "ratio");
+        for (auto &comparison : bench::compare(baseline, current, tolerance)) {
+            std::printf("%-50s %14.1f %14.1f %8.3f %s\n", comparison.name.c_str(),
+                        comparison.baselineMean, comparison.currentMean, comparison.ratio(),
+                        describe(comparison.verdict));
+            regressions += comparison.verdict == bench::Verdict::Regressed;
+        }
+
+        if (regressions > 0) {
+            std::printf("\n%d benchmark(s) regressed by more than %.1f%% outside the %.0f%% confidence interval\n",
+                        regressions, tolerance * 100, current.confidenceInterval * 100);
+            return 1;
+        }
+        return 0;
+    } catch (const std::exception &ex) {
+        std::cerr << "bench-compare: " << ex.what() << "\n";
+        return 2;
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+// Compares two benchmark runs written by the json reporter (catch-extensions/json-reporter.cpp).
+//
+// Catch's bootstrap analysis gives a confidence interval for every mean. A benchmark has only
+// regressed when its confidence interval lies entirely above the baseline's *and* the means are
+// further apart than the tolerance, so neither noise nor a statistically real but negligible
+// difference fails the gate.
+
+#include "json.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+    // Times are in nanoseconds
+    struct Result {
+        std::string name;
+        double mean = 0;
+        double lowerBound = 0;
+        double upperBound = 0;
+        double standardDeviation = 0;
+    };
+
+    struct Run {
+        double confidenceInterval = 0;
+        std::vector<Result> results;
+    };
+
+    enum class Verdict { Unchanged, Improved, Regressed, Added, Removed };
+
+    struct Comparison {
+        std::string name;
+        Verdict verdict = Verdict::Unchanged;
+        double baselineMean = 0;
+        double currentMean = 0;
+
+        // current / baseline, 0 if either side is missing
+        double ratio() const {
+            return baselineMean > 0 && currentMean > 0 ? currentMean / baselineMean : 0;
+        }
+    };
+
+    inline Run readRun(const json::Value &document) {
+        Run run;
+        run.confidenceInterval = document["confidence_interval"].number;
+        for (auto &benchmark : document["benchmarks"].array) {
+            Result result;
+            result.name = benchmark["name"].string;
+            result.mean = benchmark["mean"]["point"].number;
+            result.lowerBound = benchmark["mean"]["lower_bound"].number;
+            result.upperBound = benchmark["mean"]["upper_bound"].number;
+            result.standardDeviation = benchmark["standard_deviation"]["point"].number;
+            run.results.push_back(result);
+        }
+        return run;
+    }
+
+    inline Verdict judge(const Result &baseline, const Result &current, double tolerance) {
+        if (current.lowerBound > baseline.upperBound && current.mean > baseline.mean * (1 + tolerance)) {
+            return Verdict::Regressed;
+        }
+        if (current.upperBound < baseline.lowerBound && current.mean < baseline.mean * (1 - tolerance)) {
+            return Verdict::Improved;
+        }
+        return Verdict::Unchanged;
+    }
+
+    // In the order of the current run, followed by whatever only the baseline has
+    inline std::vector<Comparison> compare(const Run &baseline, const Run &current, double tolerance) {
+        auto find = [](const Run &run, const std::string &name) {
+            return std::find_if(run.results.begin(), run.results.end(),
+                                [&name](const Result &r) { return r.name == name; });
+        };
+
+        std::vector<Comparison> comparisons;
+        for (auto &result : current.results) {
+            Comparison comparison;
+            comparison.name = result.name;
+            comparison.currentMean = result.mean;
+            auto previous = find(baseline, result.name);
+            if (previous == baseline.results.end()) {
+                comparison.verdict = Verdict::Added;
+            } else {
+                comparison.baselineMean = previous->mean;
+                comparison.verdict = judge(*previous, result, tolerance);
+            }
+            comparisons.push_back(comparison);
+        }
+        for (auto &result : baseline.results) {
+            if (find(current, result.name) == current.results.end()) {
+                Comparison comparison;
+                comparison.name = result.name;
+                comparison.verdict = Verdict::Removed;
+                comparison.baselineMean = result.mean;
+                comparisons.push_back(comparison);
+            }
+        }
+        return comparisons;
+    }
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+// Just enough JSON for the files our own reporters and tools write and read back:
+// a Value tree, a recursive descent parser and string escaping.
+
+#include <cstdlib>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace json {
+
+    struct Value {
+        enum class Type { Null, Bool, Number, String, Array, Object };
+
+        Type type = Type::Null;
+        bool boolean = false;
+        double number = 0;
+        std::string string;
+        std::vector<Value> array;
+        std::map<std::string, Value> object;
+
+        bool has(const std::string &key) const {
+            return type == Type::Object && object.count(key) != 0;
+        }
+
+        const Value &operator[](const std::string &key) const {
+            auto it = object.find(key);
+            if (type != Type::Object || it == object.end()) {
+                throw std::runtime_error("missing JSON key \"" + key + "\"");
+            }
+            return it->second;
+        }
+    };
+
+    inline std::string escape(const std::string &s) {
+        std::string out;
+        out.reserve(s.size() + 2);
+        for (char c : s) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        static const char hex[] = "0123456789abcdef";
+                        out += "\\u00";
+                        out += hex[(c >> 4) & 0xf];
+                        out += hex[c & 0xf];
+                    } else {
+                        out += c;
+                    }
+            }
+        }
+        return out;
+    }
+
+    namespace detail {
+        class Parser {
+        public:
+            explicit Parser(const std::string &text) : text(text) {}
+
+            Value parseDocument() {
+                auto value = parseValue();
+                skipWhitespace();
+                if (pos != text.size()) {
+                    fail("trailing characters");
+                }
+                return value;
+            }
+
+        private:
+            const std::string &text;
+            std::size_t pos = 0;
+
+            [[noreturn]] void fail(const std::string &what) const {
+                throw std::runtime_error("invalid JSON at offset " + std::to_string(pos) + ": " + what);
+            }
+
+            void skipWhitespace() {
+                while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\r' || text[pos] == '\t')) {
+                    ++pos;
+                }
+            }
+
+            char peek() {
+                skipWhitespace();
+                if (pos == text.size()) {
+                    fail("unexpected end of input");
+                }
+                return text[pos];
+            }
+
+            void expect(char c) {
+                if (peek() != c) {
+                    fail(std::string("expected '") + c + "'");
+                }
+                ++pos;
+            }
+
+            bool consume(const char *literal) {
+                std::string l(literal);
+                if (text.compare(pos, l.size(), l) == 0) {
+                    pos += l.size();
+                    return true;
+                }
+                return false;
+            }
+
+            Value parseValue() {
+                Value value;
+                char c = peek();
+                if (c == '{') {
+                    value.type = Value::Type::Object;
+                    ++pos;
+                    if (peek() == '}') {
+                        ++pos;
+                        return value;
+                    }
+                    do {
+                        auto key = parseString();
+                        expect(':');
+                        value.object[key] = parseValue();
+                    } while (peek() == ',' && ++pos);
+                    expect('}');
+                } else if (c == '[') {
+                    value.type = Value::Type::Array;
+                    ++pos;
+                    if (peek() == ']') {
+                        ++pos;
+                        return value;
+                    }
+                    do {
+                        value.array.push_back(parseValue());
+                    } while (peek() == ',' && ++pos);
+                    expect(']');
+                } else if (c == '"') {
+                    value.type = Value::Type::String;
+                    value.string = parseString();
+                } else if (consume("true")) {
+                    value.type = Value::Type::Bool;
+                    value.boolean = true;
+                } else if (consume("false")) {
+                    value.type = Value::Type::Bool;
+                } else if (consume("null")) {
+                    value.type = Value::Type::Null;
+                } else {
+                    value.type = Value::Type::Number;
+                    const char *begin = text.c_str() + pos;
+                    char *end = nullptr;
+                    value.number = std::strtod(begin, &end);
+                    if (end == begin) {
+                        fail("expected a value");
+                    }
+                    pos += end - begin;
+                }
+                return value;
+            }
+
+            std::string parseString() {
+                expect('"');
+                std::string out;
+                while (pos < text.size() && text[pos] != '"') {
+                    char c = text[pos++];
+                    if (c != '\\') {
+                        out += c;
+                        continue;
+                    }
+                    if (pos == text.size()) {
+                        break;
+                    }
+                    switch (char e = text[pos++]) {
+                        case 'n': out += '\n'; break;
+                        case 'r': out += '\r'; break;
+                        case 't': out += '\t'; break;
+                        case 'b': out += '\b'; break;
+                        case 'f': out += '\f'; break;
+                        case 'u': {
+                            // Only what escape() produces: code points below 0x80
+                            if (pos + 4 > text.size()) {
+                                fail("truncated \\u escape");
+                            }
+                            out += static_cast<char>(std::stoi(text.substr(pos, 4), nullptr, 16));
+                            pos += 4;
+                            break;
+                        }
+                        default: out += e;
+                    }
+                }
+                if (pos == text.size()) {
+                    fail("unterminated string");
+                }
+                ++pos;
+                return out;
+            }
+        };
+    }
+
+    // Throws std::runtime_error if the text isn't valid JSON
+    inline Value parse(const std::string &text) {
+        return detail::Parser(text).parseDocument();
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+// Merges the JUnit reports of several runs of the same test binary (as written by Catch's junit
+// reporter) into one report with a single <testsuite>.
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace junit {
+
+    struct Suite {
+        int errors = 0;
+        int failures = 0;
+        int tests = 0;
+        double time = 0;
+        std::string testCases;
+        std::string systemOut;
+        std::string systemErr;
+    };
+
+    namespace detail {
+        inline std::string attribute(const std::string &tag, const std::string &name) {
+            auto key = " " + name + "=\"";
+            auto begin = tag.find(key);
+            if (begin == std::string::npos) {
+                return "";
+            }
+            begin += key.size();
+            return tag.substr(begin, tag.find('"', begin) - begin);
+        }
+
+        // Removes <name>...</name> (or <name/>) from xml and returns what was inside it
+        inline std::string extract(std::string &xml, const std::string &name) {
+            auto empty = xml.find("<" + name + "/>");
+            if (empty != std::string::npos) {
+                xml.erase(empty, name.size() + 3);
+                return "";
+            }
+            auto open = "<" + name + ">";
+            auto close = "</" + name + ">";
+            auto begin = xml.find(open);
+            auto end = xml.find(close, begin);
+            if (begin == std::string::npos || end == std::string::npos) {
+                return "";
+            }
+            auto content = xml.substr(begin + open.size(), end - begin - open.size());
+            xml.erase(begin, end + close.size() - begin);
+            return content;
+        }
+
+        inline std::string trim(const std::string &s) {
+            auto begin = s.find_first_not_of(" \n\r\t");
+            auto end = s.find_last_not_of(" \n\r\t");
+            return begin == std::string::npos ? "" : s.substr(begin, end - begin + 1);
+        }
+    }
+
+    inline bool isComplete(const std::string &xml) {
+        return xml.find("</testsuites>") != std::string::npos;
+    }
+
+    // The first <testsuite> of a report
+    inline Suite parse(const std::string &xml) {
+        Suite suite;
+        auto begin = xml.find("<testsuite ");
+        auto end = xml.find("</testsuite>", begin);
+        if (begin == std::string::npos || end == std::string::npos) {
+            return suite;
+        }
+        auto tagEnd = xml.find('>', begin);
+        auto tag = xml.substr(begin, tagEnd - begin);
+        suite.errors = std::atoi(detail::attribute(tag, "errors").c_str());
+        suite.failures = std::atoi(detail::attribute(tag, "failures").c_str());
+        suite.tests = std::atoi(detail::attribute(tag, "tests").c_str());
+        suite.time = std::atof(detail::attribute(tag, "time").c_str());
+
+        auto content = xml.substr(tagEnd + 1, end - tagEnd - 1);
+        detail::extract(content, "properties");
+        suite.systemOut = detail::trim(detail::extract(content, "system-out"));
+        suite.systemErr = detail::trim(detail::extract(content, "system-err"));
+        suite.testCases = detail::trim(content);
+        return suite;
+    }
+
+    // time is the wall clock time of the whole (parallel) run, not the sum of the suites'
+    inline std::string merge(const std::vector<Suite> &suites, const std::string &name, double time) {
+        Suite merged;
+        for (auto &suite : suites) {
+            merged.errors += suite.errors;
+            merged.failures += suite.failures;
+            merged.tests += suite.tests;
+            for (auto part : {std::make_pair(&merged.testCases, &suite.testCases),
+                              std::make_pair(&merged.systemOut, &suite.systemOut),
+                              std::make_pair(&merged.systemErr, &suite.systemErr)}) {
+                if (!part.second->empty()) {
+                    *part.first += (part.first->empty() ? "" : "\n    ") + *part.second;
+                }
+            }
+        }
+
+        std::string xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n";
+        xml += "  <testsuite name=\"" + name + "\" errors=\"" + std::to_string(merged.errors) +
+               "\" failures=\"" + std::to_string(merged.failures) + "\" tests=\"" + std::to_string(merged.tests) +
+               "\" hostname=\"tbd\" time=\"" + std::to_string(time) + "\">\n";
+        if (!merged.testCases.empty()) {
+            xml += "    " + merged.testCases + "\n";
+        }
+        xml += "    <system-out>\n" + merged.systemOut + "\n    </system-out>\n";
+        xml += "    <system-err>\n" + merged.systemErr + "\n    </system-err>\n";
+        xml += "  </testsuite>\n</testsuites>\n";
+        return xml;
+    }
+}
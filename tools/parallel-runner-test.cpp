@@ -0,0 +1,136 @@
+#include "catch.hpp"
+
+#include "junit.hpp"
+#include "shards.hpp"
+#include "test-cache.hpp"
+
+TEST_CASE("Sharding by duration", "[shards][parallel]") {
+    history::History history;
+    history["slow"].seconds = 4;
+    history["medium"].seconds = 3;
+    history["quick"].seconds = 1;
+    history["quicker"].seconds = 1;
+
+    SECTION("Longest test first, into the least loaded shard") {
+        auto shards = shards::partition({"quick", "slow", "quicker", "medium"}, history, 2);
+
+        REQUIRE(shards.size() == 2);
+        REQUIRE(shards[0].tests == std::vector<std::string>{"slow", "quicker"});
+        REQUIRE(shards[1].tests == std::vector<std::string>{"medium", "quick"});
+        REQUIRE(shards[0].seconds == 5);
+        REQUIRE(shards[1].seconds == 4);
+    }
+
+    SECTION("Never more shards than tests") {
+        REQUIRE(shards::partition({"slow", "quick"}, history, 8).size() == 2);
+        REQUIRE(shards::partition({}, history, 8).size() == 1);
+    }
+
+    SECTION("Tests without history still spread out") {
+        auto shards = shards::partition({"a", "b", "c", "d"}, history::History{}, 2);
+
+        REQUIRE(shards[0].tests.size() == 2);
+        REQUIRE(shards[1].tests.size() == 2);
+    }
+}
+
+TEST_CASE("Test records", "[history][parallel]") {
+    auto records = history::parseRecords("{\"name\": \"a\", \"seconds\": 0.5, \"passed\": true}\n"
+                                         "\n"
+                                         "{\"name\": \"b\", \"seconds\": 2, \"passed\": false}\n");
+    REQUIRE(records.size() == 2);
+    REQUIRE(records[1].name == "b");
+    REQUIRE(records[1].seconds == 2);
+    REQUIRE_FALSE(records[1].passed);
+
+    history::History history;
+    history::update(history, records);
+    REQUIRE(history["a"].seconds == 0.5);
+    REQUIRE(history["a"].failureRate == 0);
+    REQUIRE(history["b"].failureRate == 0.5);
+
+    SECTION("Older failures count for less") {
+        history::update(history, {{"b", 2, true}});
+        REQUIRE(history["b"].failureRate == 0.25);
+    }
+}
+
+TEST_CASE("Ordering by history", "[history][parallel]") {
+    history::History history;
+    history["quick"] = {0.1, 0};
+    history["slow"] = {5, 0};
+    history["flaky"] = {1, 0.25};
+    history["broken"] = {3, 0.75};
+
+    std::vector<std::string> tests{"slow", "quick", "new", "flaky", "broken"};
+    history::sortByHistory(tests, history, [](const std::string &test) { return test; });
+    REQUIRE(tests == std::vector<std::string>{"new", "broken", "flaky", "quick", "slow"});
+}
+
+TEST_CASE("Test result cache", "[cache][parallel]") {
+    REQUIRE(cache::quotedIncludes("#include \"catch.hpp\"\n"
+                                  "  #  include \"tools/json.hpp\" // comment\n"
+                                  "#include <vector>\n"
+                                  "#define X\n"
+                                  "#\n") == std::vector<std::string>{"catch.hpp", "tools/json.hpp"});
+    REQUIRE(cache::fnv1a("") == 14695981039346656037ull);
+    REQUIRE(cache::fnv1a("a") == 0xaf63dc4c8601ec8cull);
+
+    cache::Cache testCache{{"passed", {"abc", true}}, {"failed", {"abc", false}}};
+    REQUIRE(cache::isUpToDate(testCache, "passed", "abc"));
+    REQUIRE_FALSE(cache::isUpToDate(testCache, "passed", "def"));
+    REQUIRE_FALSE(cache::isUpToDate(testCache, "failed", "abc"));
+    REQUIRE_FALSE(cache::isUpToDate(testCache, "new", "abc"));
+
+    SECTION("Sources that can't be read are never up to date") {
+        cache::SourceHasher hasher;
+        auto sources = hasher.hash("no/such/file.cpp");
+        REQUIRE(sources.empty());
+        REQUIRE_FALSE(cache::isUpToDate({{"test", {sources, true}}}, "test", sources));
+    }
+}
+
+TEST_CASE("Merging JUnit reports", "[junit][parallel]") {
+    std::string first = R"(<?xml version="1.0" encoding="UTF-8"?>
+<testsuites>
+  <testsuite name="cpp_playground" errors="0" failures="1" tests="3" hostname="tbd" time="0.5" timestamp="now">
+    <properties>
+      <property name="filters" value="a"/>
+    </properties>
+    <testcase classname="cpp_playground.global" name="a" time="0.5">
+      <failure message="1 == 2" type="REQUIRE"/>
+    </testcase>
+    <system-out>
+hello
+    </system-out>
+    <system-err/>
+  </testsuite>
+</testsuites>
+)";
+    std::string second = R"(<?xml version="1.0" encoding="UTF-8"?>
+<testsuites>
+  <testsuite name="cpp_playground" errors="1" failures="0" tests="2" hostname="tbd" time="0.25" timestamp="now">
+    <testcase classname="cpp_playground.global" name="b" time="0.25"/>
+    <system-out/>
+    <system-err/>
+  </testsuite>
+</testsuites>
+)";
+
+    REQUIRE(junit::isComplete(first));
+    REQUIRE_FALSE(junit::isComplete("<testsuites><testsuite name=\"x\">"));
+
+    auto suite = junit::parse(first);
+    REQUIRE(suite.failures == 1);
+    REQUIRE(suite.tests == 3);
+    REQUIRE(suite.time == 0.5);
+    REQUIRE(suite.systemOut == "hello");
+    REQUIRE(suite.systemErr.empty());
+    REQUIRE(suite.testCases.find("<property") == std::string::npos);
+
+    auto merged = junit::merge({suite, junit::parse(second)}, "cpp_playground", 0.5);
+    REQUIRE(merged.find("errors=\"1\" failures=\"1\" tests=\"5\"") != std::string::npos);
+    REQUIRE(merged.find("name=\"a\"") != std::string::npos);
+    REQUIRE(merged.find("name=\"b\"") != std::string::npos);
+    REQUIRE(junit::parse(merged).systemOut == "hello");
+}
@@ -0,0 +1,211 @@
+// Runs a Catch test binary as several concurrent processes ("shards") and merges their JUnit reports.
+//
+// usage: parallel-runner [-j shards] [--history file] [-o report.xml] <test-binary> [test spec...]
+//
+// The test cases matching the test spec (all of them by default) are split into shards of roughly
+// equal duration, using the durations recorded in the history file by previous runs. Every shard's
+// output goes to a log file; the merged JUnit report goes to report.xml.
+
+#include "junit.hpp"
+#include "shards.hpp"
+#include "test-history.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+    struct Arguments {
+        std::size_t shards = std::max(1u, std::thread::hardware_concurrency());
+        std::string historyFile = "test-history.json";
+        std::string reportFile = "test-results.xml";
+        std::string binary;
+        std::vector<std::string> testSpec;
+    };
+
+    Arguments parseArguments(int argc, char **argv) {
+        Arguments args;
+        int i = 1;
+        for (; i < argc && argv[i][0] == '-'; i += 2) {
+            std::string option = argv[i];
+            if (i + 1 == argc) {
+                throw std::runtime_error(option + " needs a value");
+            }
+            if (option == "-j") {
+                args.shards = std::stoul(argv[i + 1]);
+            } else if (option == "--history") {
+                args.historyFile = argv[i + 1];
+            } else if (option == "-o") {
+                args.reportFile = argv[i + 1];
+            } else {
+                throw std::runtime_error("unknown option " + option);
+            }
+        }
+        if (i == argc) {
+            throw std::runtime_error("no test binary given");
+        }
+        args.binary = argv[i++];
+        args.testSpec.assign(argv + i, argv + argc);
+        return args;
+    }
+
+    // Starts `args` with stdout (and stderr) going to outputFile, or to a pipe if outputFile is empty
+    pid_t spawn(const std::vector<std::string> &args, const std::string &outputFile, int *pipeRead = nullptr) {
+        int fds[2] = {-1, -1};
+        if (pipeRead && pipe(fds) != 0) {
+            throw std::runtime_error("pipe failed");
+        }
+        pid_t pid = fork();
+        if (pid < 0) {
+            throw std::runtime_error("fork failed");
+        }
+        if (pid == 0) {
+            int out = pipeRead ? fds[1] : open(outputFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            dup2(out, STDOUT_FILENO);
+            if (!pipeRead) {
+                dup2(out, STDERR_FILENO);
+            }
+            std::vector<char *> argv;
+            for (auto &arg : args) {
+                argv.push_back(const_cast<char *>(arg.c_str()));
+            }
+            argv.push_back(nullptr);
+            execv(argv[0], argv.data());
+            std::perror(argv[0]);
+            _exit(127);
+        }
+        if (pipeRead) {
+            close(fds[1]);
+            *pipeRead = fds[0];
+        }
+        return pid;
+    }
+
+    int wait(pid_t pid) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+    }
+
+    std::vector<std::string> listTests(const Arguments &args) {
+        std::vector<std::string> command{args.binary, "--list-test-names-only"};
+        command.insert(command.end(), args.testSpec.begin(), args.testSpec.end());
+
+        int fd = -1;
+        pid_t pid = spawn(command, "", &fd);
+        std::string output;
+        char buffer[4096];
+        ssize_t n;
+        while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+            output.append(buffer, n);
+        }
+        close(fd);
+        wait(pid);
+
+        std::vector<std::string> tests;
+        std::size_t begin = 0;
+        for (auto end = output.find('\n'); end != std::string::npos; begin = end + 1, end = output.find('\n', begin)) {
+            if (end > begin) {
+                tests.push_back(output.substr(begin, end - begin));
+            }
+        }
+        return tests;
+    }
+
+    std::string makeWorkDirectory() {
+        char pattern[] = "/tmp/parallel-runner-XXXXXX";
+        if (!mkdtemp(pattern)) {
+            throw std::runtime_error("could not create a temporary directory");
+        }
+        return pattern;
+    }
+}
+
+int main(int argc, char **argv) {
+    try {
+        auto args = parseArguments(argc, argv);
+        auto start = std::chrono::steady_clock::now();
+
+        auto tests = listTests(args);
+        if (tests.empty()) {
+            std::cerr << "parallel-runner: no test cases matched\n";
+            return 2;
+        }
+        auto testHistory = history::load(args.historyFile);
+        auto plan = shards::partition(tests, testHistory, args.shards);
+        auto dir = makeWorkDirectory();
+
+        std::vector<pid_t> pids;
+        for (std::size_t i = 0; i < plan.size(); ++i) {
+            auto prefix = dir + "/shard-" + std::to_string(i);
+            std::ofstream testList(prefix + ".tests");
+            for (auto &test : plan[i].tests) {
+                testList << test << "\n";
+            }
+            testList.close();
+            pids.push_back(spawn({args.binary, "-f", prefix + ".tests", "-r", "junit", "-o", prefix + ".xml",
+                                  "--record", prefix + ".jsonl"}, prefix + ".log"));
+        }
+
+        bool failed = false;
+        std::vector<junit::Suite> suites;
+        for (std::size_t i = 0; i < plan.size(); ++i) {
+            auto prefix = dir + "/shard-" + std::to_string(i);
+            int status = wait(pids[i]);
+            auto report = history::readFile(prefix + ".xml");
+            std::printf("shard %zu: %zu test cases, expected %.3fs, exit code %d\n",
+                        i, plan[i].tests.size(), plan[i].seconds, status);
+
+            if (junit::isComplete(report)) {
+                suites.push_back(junit::parse(report));
+            } else {
+                // It crashed (or never started), so report the whole shard as an error
+                junit::Suite crashed;
+                crashed.errors = 1;
+                crashed.tests = 1;
+                crashed.testCases = "<testcase classname=\"parallel-runner\" name=\"shard " + std::to_string(i) +
+                                    "\" time=\"0\"><error message=\"exited with " + std::to_string(status) +
+                                    " without finishing its report, see " + prefix + ".log\"/></testcase>";
+                suites.push_back(crashed);
+            }
+            history::update(testHistory, history::parseRecords(history::readFile(prefix + ".jsonl")));
+            failed = failed || status != 0;
+        }
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::ofstream(args.reportFile) << junit::merge(suites, args.binary, seconds);
+        history::save(testHistory, args.historyFile);
+
+        int assertions = 0, failures = 0;
+        for (auto &suite : suites) {
+            assertions += suite.tests;
+            failures += suite.failures + suite.errors;
+        }
+        std::printf("%zu test cases, %d assertions, %d failed, in %zu shards, %.3fs\n",
+                    tests.size(), assertions, failures, plan.size(), seconds);
+        if (failed) {
+            std::printf("shard reports and logs are in %s\n", dir.c_str());
+            return 1;
+        }
+        for (std::size_t i = 0; i < plan.size(); ++i) {
+            for (auto extension : {".tests", ".xml", ".jsonl", ".log"}) {
+                std::remove((dir + "/shard-" + std::to_string(i) + extension).c_str());
+            }
+        }
+        rmdir(dir.c_str());
+        return 0;
+    } catch (const std::exception &ex) {
+        std::cerr << "parallel-runner: " << ex.what() << "\n";
+        return 2;
+    }
+}
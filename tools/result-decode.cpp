@@ -0,0 +1,62 @@
+// Converts a result stream written by the binary reporter (catch-extensions/binary-reporter.cpp)
+// to a JUnit report or to JSON.
+//
+// usage: result-decode [--junit | --json] <results.bin> [-o output]
+//
+// Fails (exit code 1) if the stream ends early, e.g. because the tests crashed, after converting
+// what it has.
+
+#include "result-stream.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+int main(int argc, char **argv) {
+    std::string format = "--junit";
+    std::string input;
+    std::string output;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--junit" || arg == "--json") {
+            format = arg;
+        } else if (arg == "-o" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (input.empty() && arg[0] != '-') {
+            input = arg;
+        } else {
+            input.clear();
+            break;
+        }
+    }
+    if (input.empty()) {
+        std::cerr << "usage: " << argv[0] << " [--junit | --json] <results.bin> [-o output]\n";
+        return 2;
+    }
+
+    try {
+        std::ifstream in(input, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("could not open " + input);
+        }
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        auto run = results::decode(buffer.str());
+
+        auto converted = format == "--json" ? results::toJson(run) : results::toJUnit(run);
+        if (output.empty()) {
+            std::cout << converted;
+        } else {
+            std::ofstream(output) << converted;
+        }
+        if (!run.ended) {
+            std::cerr << input << " ends before the test run does\n";
+            return 1;
+        }
+    } catch (std::exception &e) {
+        std::cerr << "error: " << e.what() << "\n";
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include "catch.hpp"
+
+#include "result-stream.hpp"
+
+namespace {
+    using results::Event;
+    using results::Record;
+
+    std::string stream(std::initializer_list<Record> records) {
+        std::ostringstream out;
+        out << results::magic;
+        for (auto &record : records) {
+            record.writeTo(out);
+        }
+        return out.str();
+    }
+
+    Record failure(const std::string &expansion) {
+        Record record(Event::Assertion);
+        record.u8(static_cast<std::uint8_t>(results::Outcome::Failed)).string("REQUIRE")
+                .string("x == 2").string(expansion).string("x is <1>").string("a.cpp").u32(7);
+        return record;
+    }
+}
+
+TEST_CASE("Result streams", "[result-stream][parallel]") {
+    auto complete = stream({
+            Record(Event::RunStarting).string("tests"),
+            Record(Event::TestCaseStarting).string("Passes").string("a.cpp").u32(3).string("[a]"),
+            Record(Event::SectionEnded).string("Passes").f64(0.25).u64(2).u64(0),
+            Record(Event::TestCaseEnded).f64(0.25).u64(2).u64(0).string("hello\n").string(""),
+            Record(Event::TestCaseStarting).string("Fails").string("a.cpp").u32(6).string(""),
+            failure("1 == 2"),
+            Record(Event::TestCaseEnded).f64(0.5).u64(0).u64(1).string("").string(""),
+            Record(Event::RunEnded).u8(0)
+    });
+
+    SECTION("Decoding") {
+        auto run = results::decode(complete);
+        REQUIRE(run.name == "tests");
+        REQUIRE(run.ended);
+        REQUIRE(run.testCases.size() == 2);
+        REQUIRE(run.testCases[0].tags == "[a]");
+        REQUIRE(run.testCases[0].sections.size() == 1);
+        REQUIRE(run.testCases[0].sections[0].seconds == 0.25);
+        REQUIRE(run.testCases[0].stdOut == "hello\n");
+        REQUIRE(run.testCases[1].failed == 1);
+        REQUIRE(run.testCases[1].assertions.size() == 1);
+        REQUIRE(run.testCases[1].assertions[0].expansion == "1 == 2");
+        REQUIRE(run.testCases[1].assertions[0].line == 7);
+    }
+
+    SECTION("A stream cut short decodes up to its last whole record") {
+        auto run = results::decode(complete.substr(0, complete.size() - 12));
+        REQUIRE_FALSE(run.ended);
+        REQUIRE(run.testCases.size() == 2);
+        REQUIRE(run.testCases[0].ended);
+        REQUIRE_FALSE(run.testCases[1].ended);
+        REQUIRE(run.testCases[1].assertions.size() == 1);
+    }
+
+    SECTION("Unknown events are skipped") {
+        auto run = results::decode(stream({
+                Record(Event::TestCaseStarting).string("Passes").string("a.cpp").u32(3).string(""),
+                Record(static_cast<Event>(99)).string("from a newer reporter"),
+                Record(Event::TestCaseEnded).f64(0.25).u64(2).u64(0).string("").string("")
+        }));
+        REQUIRE(run.testCases.size() == 1);
+        REQUIRE(run.testCases[0].passed == 2);
+    }
+
+    SECTION("Anything else is rejected") {
+        REQUIRE_THROWS(results::decode("<?xml version=\"1.0\"?>"));
+        Record unknownOutcome(Event::Assertion);
+        unknownOutcome.u8(3).string("REQUIRE").string("").string("").string("").string("a.cpp").u32(7);
+        REQUIRE_THROWS_AS(results::decode(stream({
+                Record(Event::TestCaseStarting).string("Fails").string("a.cpp").u32(6).string(""),
+                unknownOutcome
+        })), std::runtime_error);
+    }
+
+    SECTION("JUnit") {
+        auto xml = results::toJUnit(results::decode(complete));
+        REQUIRE(xml.find("errors=\"0\" failures=\"1\" tests=\"2\" time=\"0.75\"") != std::string::npos);
+        REQUIRE(xml.find("<testcase classname=\"tests\" name=\"Fails\" time=\"0.5\">") != std::string::npos);
+        REQUIRE(xml.find("<failure message=\"1 == 2\" type=\"REQUIRE\">\nx is &lt;1&gt;\nat a.cpp:7\n") != std::string::npos);
+        REQUIRE(xml.find("<system-out>\nhello\n") != std::string::npos);
+    }
+
+    SECTION("JSON") {
+        auto value = json::parse(results::toJson(results::decode(complete)));
+        REQUIRE(value["ended"].boolean);
+        REQUIRE(value["test_cases"].array.size() == 2);
+        REQUIRE(value["test_cases"].array[0]["sections"].array[0]["passed"].number == 2);
+        REQUIRE(value["test_cases"].array[1]["assertions"].array[0]["outcome"].string == "failed");
+    }
+}
@@ -0,0 +1,402 @@
+#pragma once
+
+// A compact binary stream of test results, as written by the "binary" reporter
+// (catch-extensions/binary-reporter.cpp), and its conversion to JUnit or JSON (see result-decode.cpp).
+//
+// The stream starts with the 8 bytes "CATCHRS1", then has one record per event:
+//   u32 length | u8 event | the event's fields (length - 1 bytes)
+// Integers are little endian, doubles are written as the u64 of their bits and strings as a u32
+// length and the bytes. Thanks to the length a reader can skip the events it doesn't know, and a
+// stream that was cut short (by a crash, say) still decodes up to its last whole record.
+
+#include "json.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace results {
+
+    const std::string magic = "CATCHRS1";
+
+    enum class Event : std::uint8_t {
+        RunStarting = 1,  // name
+        TestCaseStarting, // name, file, line (u32), tags
+        SectionEnded,     // name, seconds, passed (u64), failed (u64)
+        Assertion,        // outcome (u8), macro, expression, expansion, message, file, line (u32)
+        Benchmark,        // name, iterations (u64), mean, lower bound, upper bound, standard deviation,
+                          // samples (a u32 count of doubles), all in nanoseconds
+        TestCaseEnded,    // seconds, passed (u64), failed (u64), stdout, stderr
+        RunEnded          // aborting (u8)
+    };
+
+    enum class Outcome : std::uint8_t { Passed, Failed, Error };
+
+    // One event's record, built field by field
+    class Record {
+    public:
+        explicit Record(Event event) : Record(static_cast<std::uint8_t>(event)) {}
+
+        // For streams with events of their own (see catch-extensions/fork-session.hpp)
+        explicit Record(std::uint8_t event) : bytes(1, static_cast<char>(event)) {}
+
+        Record &u8(std::uint8_t value) {
+            bytes.push_back(static_cast<char>(value));
+            return *this;
+        }
+
+        Record &u32(std::uint32_t value) {
+            for (int i = 0; i < 4; ++i) {
+                bytes.push_back(static_cast<char>(value >> (8 * i)));
+            }
+            return *this;
+        }
+
+        Record &u64(std::uint64_t value) {
+            for (int i = 0; i < 8; ++i) {
+                bytes.push_back(static_cast<char>(value >> (8 * i)));
+            }
+            return *this;
+        }
+
+        Record &f64(double value) {
+            std::uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return u64(bits);
+        }
+
+        Record &string(const std::string &value) {
+            u32(static_cast<std::uint32_t>(value.size()));
+            bytes += value;
+            return *this;
+        }
+
+        void writeTo(std::ostream &out) const {
+            char length[4];
+            for (int i = 0; i < 4; ++i) {
+                length[i] = static_cast<char>(bytes.size() >> (8 * i));
+            }
+            out.write(length, 4);
+            out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+        }
+
+        // What writeTo writes
+        void appendTo(std::string &out) const {
+            for (int i = 0; i < 4; ++i) {
+                out.push_back(static_cast<char>(bytes.size() >> (8 * i)));
+            }
+            out += bytes;
+        }
+
+    private:
+        std::string bytes;
+    };
+
+    // Reads a record's fields back, in the order they were written
+    class Fields {
+    public:
+        Fields(const char *data, std::size_t size) : data(data), size(size) {}
+
+        std::uint8_t u8() {
+            return static_cast<std::uint8_t>(take(1)[0]);
+        }
+
+        std::uint32_t u32() {
+            return static_cast<std::uint32_t>(little(take(4), 4));
+        }
+
+        std::uint64_t u64() {
+            return little(take(8), 8);
+        }
+
+        double f64() {
+            auto bits = u64();
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        std::string string() {
+            auto length = u32();
+            return std::string(take(length), length);
+        }
+
+    private:
+        const char *data;
+        std::size_t size;
+
+        const char *take(std::size_t n) {
+            if (n > size) {
+                throw std::runtime_error("malformed record");
+            }
+            auto field = data;
+            data += n;
+            size -= n;
+            return field;
+        }
+
+        static std::uint64_t little(const char *bytes, int n) {
+            std::uint64_t value = 0;
+            for (int i = 0; i < n; ++i) {
+                value |= static_cast<std::uint64_t>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+            }
+            return value;
+        }
+    };
+
+    struct Assertion {
+        Outcome outcome = Outcome::Passed;
+        std::string macro;
+        std::string expression;
+        std::string expansion;
+        std::string message;
+        std::string file;
+        std::uint32_t line = 0;
+    };
+
+    struct Section {
+        std::string name;
+        double seconds = 0;
+        std::uint64_t passed = 0;
+        std::uint64_t failed = 0;
+    };
+
+    struct Benchmark {
+        std::string name;
+        std::uint64_t iterations = 0;
+        double mean = 0;
+        double lowerBound = 0;
+        double upperBound = 0;
+        double standardDeviation = 0;
+        std::vector<double> samples;
+    };
+
+    struct TestCase {
+        std::string name;
+        std::string file;
+        std::uint32_t line = 0;
+        std::string tags;
+        // False if the stream ends before the test case does
+        bool ended = false;
+        double seconds = 0;
+        std::uint64_t passed = 0;
+        std::uint64_t failed = 0;
+        std::string stdOut;
+        std::string stdErr;
+        std::vector<Section> sections;
+        // Only the failed ones, unless the tests were run with -s
+        std::vector<Assertion> assertions;
+        std::vector<Benchmark> benchmarks;
+    };
+
+    struct Run {
+        std::string name;
+        // False if the stream ends before the run does
+        bool ended = false;
+        bool aborting = false;
+        std::vector<TestCase> testCases;
+    };
+
+    inline Run decode(const std::string &stream) {
+        if (stream.compare(0, magic.size(), magic) != 0) {
+            throw std::runtime_error("not a result stream");
+        }
+        Run run;
+        TestCase *testCase = nullptr;
+        std::size_t offset = magic.size();
+        while (offset + 4 <= stream.size()) {
+            auto length = Fields(stream.data() + offset, 4).u32();
+            if (length == 0 || offset + 4 + length > stream.size()) {
+                break;
+            }
+            Fields fields(stream.data() + offset + 5, length - 1);
+            auto event = static_cast<Event>(stream[offset + 4]);
+            offset += 4 + length;
+
+            if (event == Event::RunStarting) {
+                run.name = fields.string();
+            } else if (event == Event::TestCaseStarting) {
+                run.testCases.emplace_back();
+                testCase = &run.testCases.back();
+                testCase->name = fields.string();
+                testCase->file = fields.string();
+                testCase->line = fields.u32();
+                testCase->tags = fields.string();
+            } else if (event == Event::RunEnded) {
+                run.ended = true;
+                run.aborting = fields.u8() != 0;
+            } else if (!testCase) {
+                continue;
+            } else if (event == Event::SectionEnded) {
+                Section section;
+                section.name = fields.string();
+                section.seconds = fields.f64();
+                section.passed = fields.u64();
+                section.failed = fields.u64();
+                testCase->sections.push_back(section);
+            } else if (event == Event::Assertion) {
+                Assertion assertion;
+                auto outcome = fields.u8();
+                if (outcome > static_cast<std::uint8_t>(Outcome::Error)) {
+                    throw std::runtime_error("malformed record");
+                }
+                assertion.outcome = static_cast<Outcome>(outcome);
+                assertion.macro = fields.string();
+                assertion.expression = fields.string();
+                assertion.expansion = fields.string();
+                assertion.message = fields.string();
+                assertion.file = fields.string();
+                assertion.line = fields.u32();
+                testCase->assertions.push_back(assertion);
+            } else if (event == Event::Benchmark) {
+                Benchmark benchmark;
+                benchmark.name = fields.string();
+                benchmark.iterations = fields.u64();
+                benchmark.mean = fields.f64();
+                benchmark.lowerBound = fields.f64();
+                benchmark.upperBound = fields.f64();
+                benchmark.standardDeviation = fields.f64();
+                benchmark.samples.resize(fields.u32());
+                for (auto &sample : benchmark.samples) {
+                    sample = fields.f64();
+                }
+                testCase->benchmarks.push_back(benchmark);
+            } else if (event == Event::TestCaseEnded) {
+                testCase->ended = true;
+                testCase->seconds = fields.f64();
+                testCase->passed = fields.u64();
+                testCase->failed = fields.u64();
+                testCase->stdOut = fields.string();
+                testCase->stdErr = fields.string();
+            }
+        }
+        return run;
+    }
+
+    namespace detail {
+        inline std::string escapeXml(const std::string &s) {
+            std::string out;
+            for (char c : s) {
+                switch (c) {
+                    case '<': out += "&lt;"; break;
+                    case '>': out += "&gt;"; break;
+                    case '&': out += "&amp;"; break;
+                    case '"': out += "&quot;"; break;
+                    default: out += c;
+                }
+            }
+            return out;
+        }
+
+        inline bool hasError(const TestCase &testCase) {
+            if (!testCase.ended) {
+                return true;
+            }
+            for (auto &assertion : testCase.assertions) {
+                if (assertion.outcome == Outcome::Error) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+
+    // One <testcase> per test case, with a <failure> (or, for exceptions and crashes, an <error>)
+    // for every failed assertion
+    inline std::string toJUnit(const Run &run) {
+        int errors = 0;
+        int failures = 0;
+        double time = 0;
+        for (auto &testCase : run.testCases) {
+            errors += detail::hasError(testCase);
+            failures += !detail::hasError(testCase) && testCase.failed > 0;
+            time += testCase.seconds;
+        }
+
+        std::ostringstream xml;
+        xml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n"
+            << "  <testsuite name=\"" << detail::escapeXml(run.name) << "\" errors=\"" << errors
+            << "\" failures=\"" << failures << "\" tests=\"" << run.testCases.size()
+            << "\" time=\"" << time << "\">\n";
+        for (auto &testCase : run.testCases) {
+            xml << "    <testcase classname=\"" << detail::escapeXml(run.name) << "\" name=\""
+                << detail::escapeXml(testCase.name) << "\" time=\"" << testCase.seconds << "\">\n";
+            for (auto &assertion : testCase.assertions) {
+                if (assertion.outcome == Outcome::Passed) {
+                    continue;
+                }
+                auto element = assertion.outcome == Outcome::Error ? "error" : "failure";
+                // FAIL(), exceptions and crashes only have a message
+                auto &summary = assertion.expansion.empty() ? assertion.message : assertion.expansion;
+                xml << "      <" << element << " message=\"" << detail::escapeXml(summary)
+                    << "\" type=\"" << detail::escapeXml(assertion.macro) << "\">\n"
+                    << detail::escapeXml(assertion.message.empty() ? "" : assertion.message + "\n")
+                    << "at " << detail::escapeXml(assertion.file) << ":" << assertion.line << "\n"
+                    << "      </" << element << ">\n";
+            }
+            if (!testCase.ended) {
+                xml << "      <error message=\"the test case didn't finish\" type=\"crash\"/>\n";
+            }
+            if (!testCase.stdOut.empty()) {
+                xml << "      <system-out>\n" << detail::escapeXml(testCase.stdOut) << "      </system-out>\n";
+            }
+            if (!testCase.stdErr.empty()) {
+                xml << "      <system-err>\n" << detail::escapeXml(testCase.stdErr) << "      </system-err>\n";
+            }
+            xml << "    </testcase>\n";
+        }
+        xml << "  </testsuite>\n</testsuites>\n";
+        return xml.str();
+    }
+
+    inline std::string toJson(const Run &run) {
+        auto quote = [](const std::string &s) { return "\"" + json::escape(s) + "\""; };
+        auto boolean = [](bool b) { return b ? "true" : "false"; };
+
+        std::ostringstream out;
+        out.precision(12);
+        out << "{\n  \"name\": " << quote(run.name) << ",\n  \"ended\": " << boolean(run.ended)
+            << ",\n  \"aborting\": " << boolean(run.aborting) << ",\n  \"test_cases\": [";
+        for (std::size_t t = 0; t < run.testCases.size(); ++t) {
+            auto &testCase = run.testCases[t];
+            out << (t == 0 ? "\n" : ",\n") << "    {\"name\": " << quote(testCase.name)
+                << ", \"file\": " << quote(testCase.file) << ", \"line\": " << testCase.line
+                << ", \"tags\": " << quote(testCase.tags) << ", \"ended\": " << boolean(testCase.ended)
+                << ", \"seconds\": " << testCase.seconds << ", \"passed\": " << testCase.passed
+                << ", \"failed\": " << testCase.failed << ",\n     \"sections\": [";
+            for (std::size_t i = 0; i < testCase.sections.size(); ++i) {
+                auto &section = testCase.sections[i];
+                out << (i == 0 ? "" : ", ") << "{\"name\": " << quote(section.name) << ", \"seconds\": "
+                    << section.seconds << ", \"passed\": " << section.passed << ", \"failed\": " << section.failed << "}";
+            }
+            out << "],\n     \"assertions\": [";
+            for (std::size_t i = 0; i < testCase.assertions.size(); ++i) {
+                auto &assertion = testCase.assertions[i];
+                const char *outcomes[] = {"passed", "failed", "error"};
+                out << (i == 0 ? "" : ", ") << "{\"outcome\": \"" << outcomes[static_cast<int>(assertion.outcome)]
+                    << "\", \"macro\": " << quote(assertion.macro) << ", \"expression\": " << quote(assertion.expression)
+                    << ", \"expansion\": " << quote(assertion.expansion) << ", \"message\": " << quote(assertion.message)
+                    << ", \"file\": " << quote(assertion.file) << ", \"line\": " << assertion.line << "}";
+            }
+            out << "],\n     \"benchmarks\": [";
+            for (std::size_t i = 0; i < testCase.benchmarks.size(); ++i) {
+                auto &benchmark = testCase.benchmarks[i];
+                out << (i == 0 ? "" : ", ") << "{\"name\": " << quote(benchmark.name) << ", \"iterations\": "
+                    << benchmark.iterations << ", \"mean\": " << benchmark.mean << ", \"lower_bound\": "
+                    << benchmark.lowerBound << ", \"upper_bound\": " << benchmark.upperBound
+                    << ", \"standard_deviation\": " << benchmark.standardDeviation << ", \"samples\": [";
+                for (std::size_t s = 0; s < benchmark.samples.size(); ++s) {
+                    out << (s == 0 ? "" : ", ") << benchmark.samples[s];
+                }
+                out << "]}";
+            }
+            out << "],\n     \"stdout\": " << quote(testCase.stdOut) << ", \"stderr\": " << quote(testCase.stdErr) << "}";
+        }
+        out << "\n  ]\n}\n";
+        return out.str();
+    }
+}
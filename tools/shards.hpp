@@ -0,0 +1,54 @@
+#pragma once
+
+// Splits test cases into shards of roughly equal duration: longest test first,
+// each into the shard with the least work so far (the LPT heuristic).
+
+#include "test-history.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace shards {
+
+    struct Shard {
+        std::vector<std::string> tests;
+        double seconds = 0;
+    };
+
+    // Tests without history are assumed to take as long as the average test that has one
+    inline std::vector<Shard> partition(const std::vector<std::string> &tests, const history::History &history,
+                                        std::size_t count) {
+        double known = 0;
+        std::size_t knownCount = 0;
+        for (auto &test : tests) {
+            auto it = history.find(test);
+            if (it != history.end()) {
+                known += it->second.seconds;
+                ++knownCount;
+            }
+        }
+        double fallback = knownCount > 0 ? known / knownCount : 0;
+
+        std::vector<std::pair<double, std::string>> byDuration;
+        for (auto &test : tests) {
+            auto it = history.find(test);
+            byDuration.emplace_back(it != history.end() ? it->second.seconds : fallback, test);
+        }
+        std::stable_sort(byDuration.begin(), byDuration.end(),
+                         [](const std::pair<double, std::string> &a, const std::pair<double, std::string> &b) {
+                             return a.first > b.first;
+                         });
+
+        std::vector<Shard> result(std::max<std::size_t>(1, std::min(count, tests.size())));
+        for (auto &test : byDuration) {
+            // Ties on duration go to the shard with fewer tests, so unknown (zero) durations still spread out
+            auto lightest = std::min_element(result.begin(), result.end(), [](const Shard &a, const Shard &b) {
+                return a.seconds != b.seconds ? a.seconds < b.seconds : a.tests.size() < b.tests.size();
+            });
+            lightest->tests.push_back(test.second);
+            lightest->seconds += test.first;
+        }
+        return result;
+    }
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+// Remembers which test cases passed, and a hash of the sources they were built from:
+//   {"tests": {"Optional": {"sources": "9c1b0e2a7f3d4c55", "passed": true}}}
+// so a re-run with --cache can skip the ones that passed and whose sources haven't changed since.
+//
+// A test case's sources are the file it's defined in, every file it includes (#include "..."),
+// recursively, and the implementation next to every header it includes (factorial.cpp for
+// factorial.hpp), which is what gets linked in for it in this repo.
+
+#include "json.hpp"
+#include "test-history.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace cache {
+
+    struct Entry {
+        std::string sources;
+        bool passed = false;
+    };
+
+    using Cache = std::map<std::string, Entry>;
+
+    // FNV-1a: stable between runs and compilers, unlike std::hash
+    inline std::uint64_t fnv1a(const std::string &data, std::uint64_t hash = 14695981039346656037ull) {
+        for (unsigned char c : data) {
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // The files a source file includes with #include "..."
+    inline std::vector<std::string> quotedIncludes(const std::string &source) {
+        std::vector<std::string> includes;
+        std::istringstream lines(source);
+        std::string line;
+        while (std::getline(lines, line)) {
+            auto hash = line.find_first_not_of(" \t");
+            if (hash == std::string::npos || line[hash] != '#') {
+                continue;
+            }
+            auto directive = line.find_first_not_of(" \t", hash + 1);
+            if (directive == std::string::npos || line.compare(directive, 7, "include") != 0) {
+                continue;
+            }
+            auto open = line.find('"', directive + 7);
+            auto close = open == std::string::npos ? open : line.find('"', open + 1);
+            if (close != std::string::npos) {
+                includes.push_back(line.substr(open + 1, close - open - 1));
+            }
+        }
+        return includes;
+    }
+
+    // Hashes the sources of the test cases in a file (see the top), reading every file only once
+    class SourceHasher {
+    public:
+        // Empty if the file can't be read, so its test cases are never skipped
+        std::string hash(const std::string &file) {
+            auto cached = hashes.find(file);
+            if (cached != hashes.end()) {
+                return cached->second;
+            }
+            std::set<std::string> files;
+            collect(file, files);
+
+            std::string result;
+            if (contents.count(file)) {
+                std::uint64_t hash = fnv1a("");
+                for (auto &source : files) {
+                    hash = fnv1a(contents[source], fnv1a(source, hash));
+                }
+                char hex[17];
+                std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+                result = hex;
+            }
+            return hashes[file] = result;
+        }
+
+    private:
+        std::map<std::string, std::string> contents;
+        std::map<std::string, std::string> hashes;
+
+        static std::string directory(const std::string &path) {
+            auto slash = path.rfind('/');
+            return slash == std::string::npos ? "" : path.substr(0, slash + 1);
+        }
+
+        bool read(const std::string &path) {
+            if (contents.count(path)) {
+                return true;
+            }
+            std::ifstream in(path);
+            if (!in) {
+                return false;
+            }
+            contents[path] = history::readFile(path);
+            return true;
+        }
+
+        // Like the include path here: next to the including file, then the directories above it
+        std::string resolve(const std::string &include, const std::string &from) {
+            for (auto dir = directory(from); !dir.empty(); dir = directory(dir.substr(0, dir.size() - 1))) {
+                if (read(dir + include)) {
+                    return dir + include;
+                }
+            }
+            return "";
+        }
+
+        void collect(const std::string &file, std::set<std::string> &files) {
+            if (files.count(file) || !read(file)) {
+                return;
+            }
+            files.insert(file);
+            for (auto &include : quotedIncludes(contents[file])) {
+                auto header = resolve(include, file);
+                if (header.empty()) {
+                    continue;
+                }
+                collect(header, files);
+                auto dot = header.rfind('.');
+                if (dot != std::string::npos && header.substr(dot) != ".cpp") {
+                    collect(header.substr(0, dot) + ".cpp", files);
+                }
+            }
+        }
+    };
+
+    inline bool isUpToDate(const Cache &cache, const std::string &test, const std::string &sources) {
+        auto it = cache.find(test);
+        return !sources.empty() && it != cache.end() && it->second.passed && it->second.sources == sources;
+    }
+
+    // A missing file is an empty cache
+    inline Cache load(const std::string &path) {
+        Cache cache;
+        auto text = history::readFile(path);
+        if (text.empty()) {
+            return cache;
+        }
+        auto document = json::parse(text);
+        for (auto &test : document["tests"].object) {
+            cache[test.first] = {test.second["sources"].string, test.second["passed"].boolean};
+        }
+        return cache;
+    }
+
+    inline void save(const Cache &cache, const std::string &path) {
+        std::ofstream out(path);
+        out << "{\n  \"tests\": {";
+        bool first = true;
+        for (auto &test : cache) {
+            out << (first ? "\n" : ",\n")
+                << "    \"" << json::escape(test.first) << "\": {\"sources\": \"" << test.second.sources
+                << "\", \"passed\": " << (test.second.passed ? "true" : "false") << "}";
+            first = false;
+        }
+        out << "\n  }\n}\n";
+    }
+}
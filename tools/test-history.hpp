@@ -0,0 +1,107 @@
+#pragma once
+
+// What previous runs learned about each test case, kept in a JSON file between runs:
+//   {"tests": {"Factorial works": {"seconds": 0.000012, "failure_rate": 0.25}}}
+// It's fed by the records the tests write with --record (catch-extensions/test-record.cpp).
+
+#include "json.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace history {
+
+    struct Record {
+        std::string name;
+        double seconds = 0;
+        bool passed = true;
+    };
+
+    struct TestHistory {
+        double seconds = 0;
+        // How often it failed, weighted towards recent runs: every run halves the weight of the ones before it
+        double failureRate = 0;
+    };
+
+    using History = std::map<std::string, TestHistory>;
+
+    inline std::string readFile(const std::string &path) {
+        std::ifstream in(path);
+        std::stringstream buffer;
+        buffer << in.rdbuf();
+        return buffer.str();
+    }
+
+    // The output of --record: one JSON object per line
+    inline std::vector<Record> parseRecords(const std::string &text) {
+        std::vector<Record> records;
+        std::istringstream lines(text);
+        std::string line;
+        while (std::getline(lines, line)) {
+            if (line.empty()) {
+                continue;
+            }
+            auto value = json::parse(line);
+            records.push_back({value["name"].string, value["seconds"].number, value["passed"].boolean});
+        }
+        return records;
+    }
+
+    inline void update(History &history, const std::vector<Record> &records) {
+        for (auto &record : records) {
+            auto &test = history[record.name];
+            test.seconds = record.seconds;
+            test.failureRate = (test.failureRate + (record.passed ? 0 : 1)) / 2;
+        }
+    }
+
+    // A missing file is an empty history
+    inline History load(const std::string &path) {
+        History history;
+        auto text = readFile(path);
+        if (text.empty()) {
+            return history;
+        }
+        auto document = json::parse(text);
+        for (auto &test : document["tests"].object) {
+            history[test.first].seconds = test.second["seconds"].number;
+            if (test.second.has("failure_rate")) {
+                history[test.first].failureRate = test.second["failure_rate"].number;
+            }
+        }
+        return history;
+    }
+
+    inline void save(const History &history, const std::string &path) {
+        std::ofstream out(path);
+        out.precision(9);
+        out << "{\n  \"tests\": {";
+        bool first = true;
+        for (auto &test : history) {
+            out << (first ? "\n" : ",\n")
+                << "    \"" << json::escape(test.first) << "\": {\"seconds\": " << test.second.seconds
+                << ", \"failure_rate\": " << test.second.failureRate << "}";
+            first = false;
+        }
+        out << "\n  }\n}\n";
+    }
+
+    // Sorts tests so the ones most likely to fail come first, and otherwise the shortest first, so a
+    // failure shows up as early as possible. Tests without a history are new, and assumed to fail
+    // (as a new test usually does in a TDD loop). name(test) is the test's name in the history.
+    template<typename Test, typename Name>
+    void sortByHistory(std::vector<Test> &tests, const History &history, Name name) {
+        auto key = [&](const Test &test) {
+            auto it = history.find(name(test));
+            return it != history.end() ? std::make_pair(-it->second.failureRate, it->second.seconds)
+                                       : std::make_pair(-1.0, 0.0);
+        };
+        std::stable_sort(tests.begin(), tests.end(), [&](const Test &a, const Test &b) {
+            return key(a) < key(b);
+        });
+    }
+}